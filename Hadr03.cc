@@ -97,7 +97,7 @@ int main(int argc, char** argv)
     DetectorConstruction* det = new DetectorConstruction;
     runManager->SetUserInitialization(det);
 
-    PhysicsList* phys = new PhysicsList;
+    PhysicsList* phys = new PhysicsList(det);
     runManager->SetUserInitialization(phys);
     runManager->SetUserInitialization(new ActionInitialization(det));
 
@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file AllocTracker.hh
+/// \brief Definition of the AllocTracker class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef AllocTracker_h
+#define AllocTracker_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Heap allocation counts per thread and per phase.
+///
+/// Built with -DLDRS_ALLOC_TRACKING=ON, src/AllocTracker.cc replaces the
+/// global operator new/delete and every allocation is counted in the
+/// calling thread's slot under the phase set by the user actions. Without
+/// the option the counters stay at zero and SetPhase is a no-op.
+///
+/// Each thread owns one slot, so counting needs no atomics; the master
+/// sums the slots at begin and end of run and reports the difference.
+
+class AllocTracker
+{
+  public:
+    enum Phase { kInit = 0, kBeginOfEvent, kStepping, kEndOfEvent, kMerge, kNPhases };
+
+    struct Counts
+    {
+        uint64_t fAllocs[kNPhases] = {};
+        uint64_t fBytes[kNPhases] = {};
+        uint64_t fFrees[kNPhases] = {};
+    };
+
+  public:
+    static constexpr G4bool IsEnabled()
+    {
+#ifdef LDRS_ALLOC_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void SetPhase(Phase phase)
+    {
+#ifdef LDRS_ALLOC_TRACKING
+        fPhase = phase;
+#else
+        (void)phase;
+#endif
+    }
+
+    // sum over all thread slots
+    static Counts Total();
+    // master: remember the totals at begin of run
+    static void BeginRun();
+    // master: print the counts since BeginRun, per event
+    static void Report(G4int nEvents);
+
+#ifdef LDRS_ALLOC_TRACKING
+    static void CountAlloc(std::size_t bytes);
+    static void CountFree();
+
+  private:
+    static G4ThreadLocal Phase fPhase;
+#endif
+
+  private:
+    static Counts fRunStart;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -37,10 +37,20 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "globals.hh"
 #include "G4ThreeVector.hh"
+#include "G4RotationMatrix.hh"
+
+#include <vector>
 
 class G4LogicalVolume;
 class G4Material;
 class DetectorMessenger;
+class ScorerRegistry;
+class KillZones;
+class ImportanceBiasing;
+class WeightWindows;
+class Digitizer;
+class ImageEstimator;
+class GeometryDetectorPanel;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -54,13 +64,44 @@ class DetectorConstruction : public G4VUserDetectorConstruction
         G4VPhysicalVolume* Construct() override;
         void ConstructSDandField() override;
 
+    public:
+        // bounding box of a placed component, kept in the component's own
+        // frame so that ray tests stay exact for rotated placements
+        struct Extent
+        {
+            G4String            fName;
+            G4ThreeVector       fLo;
+            G4ThreeVector       fHi;
+            G4bool              fHollow = false;    // air cavity inside (shielding)
+            G4ThreeVector       fInnerLo;
+            G4ThreeVector       fInnerHi;
+            G4RotationMatrix    fInvRotation;       // world -> local
+            G4ThreeVector       fTranslation;
+            G4int               fCopyNo = -1;       // scintillator copy number (panels)
+        };
+
+        const std::vector<Extent>& GetExtents() const   { return fExtents; };
+        G4double DistanceToFirstBoundary(const G4ThreeVector& pos, const G4ThreeVector& dir) const;
+        // slab test: entry (tmin) and exit (tmax) distances of a ray through a box
+        static G4bool IntersectBox(const G4ThreeVector& p, const G4ThreeVector& d,
+                const G4ThreeVector& lo, const G4ThreeVector& hi, G4double& tmin, G4double& tmax);
+
     public:
         const G4VPhysicalVolume* GetWorld()     { return fPWorld; };
+        G4Material* GetWorldMaterial();
         const G4VPhysicalVolume* GetCatcher()   { return fPCatcher; };
         const G4VPhysicalVolume* GetShieldingTracker()   { return fPShieldingTracker; };
+        ScorerRegistry* GetScorers()            { return fScorers; };
+        KillZones* GetKillZones()               { return fKillZones; };
+        ImportanceBiasing* GetBiasing()         { return fBiasing; };
+        WeightWindows* GetWeightWindows()       { return fWeightWindows; };
+        Digitizer* GetDigitizer()               { return fDigitizer; };
+        ImageEstimator* GetImageEstimator()     { return fImageEstimator; };
 
         // for messenger
         //
+        // world
+        void SetWorldMaterialName(G4String);
         // placement
         void SetPosition(G4ThreeVector pos)     { fPosition = pos; };
         void SetRotation(G4ThreeVector rot)     { fRotation = rot; };
@@ -82,9 +123,19 @@ class DetectorConstruction : public G4VUserDetectorConstruction
         void SetSampleZ(G4double val)              { fSampleZ = val; };
         void SetSampleMaterialName(G4String val)   { fSampleMaterialName = val; };
         void PlaceSample();
+        void SetSampleIn(G4bool);
         // detector
         void SetDetectorPanelXY(G4double val)          { fDetectorPanelXY = val; };
         void SetDetectorPanelZ(G4double val)           { fDetectorPanelZ = val; };
+        void SetPanelPitch(G4double val)               { fPanelPitch = val; };
+        void SetPanelHitRows(G4bool val)               { fPanelHitRows = val; };
+        void SetPanelFastSim(G4bool val)               { fPanelFastSim = val; };
+        G4bool GetPanelFastSim() const                 { return fPanelFastSim; };
+        G4double GetDetectorPanelXY() const            { return fDetectorPanelXY; };
+        void PlaceDetectorPanel();
+        G4int GetNPanels() const                       { return fNPanels; };
+        // pixels per side, 0 for a monolithic panel
+        G4int GetPanelPixels() const;
         // shielding
         void SetShieldingInnerXY(G4double val)              { fShieldingInnerXY = val; };
         void SetShieldingInnerZ(G4double val)               { fShieldingInnerZ = val; };
@@ -94,6 +145,12 @@ class DetectorConstruction : public G4VUserDetectorConstruction
 
     private:
         DetectorMessenger* fDetectorMessenger = nullptr;
+        ScorerRegistry* fScorers = nullptr;
+        KillZones* fKillZones = nullptr;
+        ImportanceBiasing* fBiasing = nullptr;
+        WeightWindows* fWeightWindows = nullptr;
+        Digitizer* fDigitizer = nullptr;
+        ImageEstimator* fImageEstimator = nullptr;
 
         // for next placed volume
         G4ThreeVector       fPosition;
@@ -103,6 +160,7 @@ class DetectorConstruction : public G4VUserDetectorConstruction
         G4VPhysicalVolume*  fPWorld = nullptr;
         G4LogicalVolume*    fLWorld = nullptr;
         G4double            fWorldXYZ;
+        G4String            fWorldMaterialName;
 
         // catcher
         G4VPhysicalVolume*  fPCatcher = nullptr;
@@ -124,12 +182,18 @@ class DetectorConstruction : public G4VUserDetectorConstruction
         G4double            fSampleZ;
         G4String            fSampleMaterialName;
         G4Material*         fSampleMaterial = nullptr;
+        std::vector<std::pair<G4LogicalVolume*, G4Material*>> fSampleLogs;  // placed samples and their material
 
         // detector
         G4VPhysicalVolume*  fPDetectorPanel = nullptr;
         G4LogicalVolume*    fLDetectorPanel = nullptr;
+        GeometryDetectorPanel* fPanel = nullptr;
+        G4int               fNPanels = 0;
         G4double            fDetectorPanelXY;
         G4double            fDetectorPanelZ;
+        G4double            fPanelPitch = 0.;
+        G4bool              fPanelHitRows = true;
+        G4bool              fPanelFastSim = false;
         G4Material*         fDetectorPanelMaterial = nullptr;
 
         // shielding
@@ -139,9 +203,14 @@ class DetectorConstruction : public G4VUserDetectorConstruction
         G4double fShieldingBoratedPEThickness;
         G4double fShieldingPbThickness;
 
+        // placed components, in placement order
+        std::vector<Extent> fExtents;
+
     private:
         void DefineMaterials();
         G4VPhysicalVolume* ConstructVolumes();
+        // records a component placed at fPosition with the given rotation
+        Extent& AddExtent(const G4String& name, G4ThreeVector lo, G4ThreeVector hi, G4RotationMatrix* rotate);
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
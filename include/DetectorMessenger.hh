@@ -40,6 +40,7 @@ class DetectorConstruction;
 class G4UIdirectory;
 class G4UIcommand;
 class G4UIcmdWithAString;
+class G4UIcmdWithABool;
 class G4UIcmdWithADoubleAndUnit;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWith3Vector;
@@ -60,6 +61,8 @@ class DetectorMessenger : public G4UImessenger
 
     // directory
     G4UIdirectory* fDir = nullptr;
+    // world
+    G4UIcmdWithAString*         fSetWorldMaterialCmd = nullptr;
     // placement
     G4UIcmdWith3VectorAndUnit*  fSetPositionCmd = nullptr;
     G4UIcmdWith3Vector*         fSetRotationCmd = nullptr;
@@ -73,6 +76,7 @@ class DetectorMessenger : public G4UImessenger
     G4UIcmdWithADoubleAndUnit*  fSetSampleZCmd              = nullptr;
     G4UIcmdWithAString*         fSetSampleMaterialNameCmd   = nullptr;
     G4UIcmdWithoutParameter*    fPlaceSampleCmd             = nullptr;
+    G4UIcmdWithABool*           fSetSampleInCmd             = nullptr;
     // collimator
     G4UIcmdWithADoubleAndUnit*  fSetCollimatorXYCmd         = nullptr;
     G4UIcmdWithADoubleAndUnit*  fSetCollimatorInnerXYCmd    = nullptr;
@@ -82,6 +86,9 @@ class DetectorMessenger : public G4UImessenger
     // detector panel
     G4UIcmdWithADoubleAndUnit*  fSetDetectorPanelXYCmd         = nullptr;
     G4UIcmdWithADoubleAndUnit*  fSetDetectorPanelZCmd          = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fSetPanelPitchCmd              = nullptr;
+    G4UIcmdWithABool*           fSetPanelHitRowsCmd            = nullptr;
+    G4UIcmdWithABool*           fSetPanelFastSimCmd            = nullptr;
     G4UIcmdWithoutParameter*    fPlaceDetectorPanelCmd         = nullptr;
     // shielding
     G4UIcmdWithADoubleAndUnit*  fSetShieldingInnerXYCmd             = nullptr;
@@ -0,0 +1,149 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Digitizer.hh
+/// \brief Definition of the Digitizer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef Digitizer_h
+#define Digitizer_h 1
+
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include <cmath>
+#include <vector>
+
+class DigitizerMessenger;
+class G4Material;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Detector response of the scintillator panel, applied at end of event.
+///
+/// The light output L(E) = int dE / (1 + kB dE/dx) of electrons, protons,
+/// alphas and carbon recoils is tabulated once on a log-energy grid from
+/// the panel material's stopping powers (Birks quenching). PanelSD copies
+/// the hits of an event into a Batch (structure of arrays); Process looks
+/// up the light of every hit, smears light and time with Gaussian numbers
+/// drawn in one call for the whole batch, and flags the hits above the
+/// threshold. The quenching is applied to the summed energy of the hit
+/// with the species of its first particle.
+
+class Digitizer
+{
+  public:
+    enum { kElectron = 0, kProton, kAlpha, kCarbon, kNSpecies };
+
+    // one event's hits; thread-local, owned by the sensitive detector
+    class Batch
+    {
+      public:
+        void Clear()                            { fSpecies.clear(); fEdep.clear(); fTime.clear(); };
+        void Add(G4int pdg, G4double edep, G4double time)
+        {
+            fSpecies.push_back(Species(pdg));
+            fEdep.push_back(edep);
+            fTime.push_back(time);
+        }
+        std::size_t Size() const                { return fEdep.size(); };
+
+        // after Process
+        G4double GetLight(std::size_t i) const  { return fLight[i]; };
+        G4double GetTime(std::size_t i) const   { return fDigiTime[i]; };
+        G4bool IsAccepted(std::size_t i) const  { return fAccepted[i]; };
+
+      private:
+        friend class Digitizer;
+        std::vector<G4int> fSpecies;
+        std::vector<G4double> fEdep;
+        std::vector<G4double> fTime;
+        std::vector<G4double> fLight;
+        std::vector<G4double> fDigiTime;
+        std::vector<char> fAccepted;
+        std::vector<G4double> fNoise;
+    };
+
+  public:
+    Digitizer();
+    ~Digitizer();
+
+    void SetActive(G4bool val)                  { fActive = val; };
+    void SetBirks(G4double val)                 { fBirks = val; };
+    void SetThreshold(G4double val)             { fThreshold = val; };
+    void SetEnergyResolution(G4double val)      { fEnergyResolution = val; };
+    void SetTimeResolution(G4double val)        { fTimeResolution = val; };
+    G4bool IsActive() const                     { return fActive; };
+
+    // light-output tables for the panel material; master, at begin of run
+    void Resolve();
+
+    void Process(Batch&) const;
+
+  private:
+    static G4int Species(G4int pdg)
+    {
+        if (pdg == 2212 || pdg == 1000010020 || pdg == 1000010030) return kProton;
+        if (pdg == 1000020030 || pdg == 1000020040) return kAlpha;
+        if (pdg > 1000020040) return kCarbon;
+        return kElectron;
+    }
+
+    // electron-equivalent light of a deposit, linear in log E between nodes
+    inline G4double LightOutput(G4int species, G4double edep) const
+    {
+        const std::vector<G4double>& table = fTable[species];
+        if (table.empty()) return edep;
+        if (edep <= fEMin) return edep * table[0] / fEMin;
+        G4double x = std::log(edep / fEMin) * fInvDLogE;
+        G4int k = (G4int)x;
+        if (k >= kNNodes - 1) return table[kNNodes - 1] + (edep - fEMax) * fTailSlope[species];
+        return table[k] + (x - k) * (table[k + 1] - table[k]);
+    }
+
+  private:
+    static const G4int kNNodes = 200;
+
+    DigitizerMessenger* fMessenger = nullptr;
+
+    G4bool fActive = false;
+    G4double fBirks = -1.;                  // < 0: from the material
+    G4double fThreshold = 0.;               // electron-equivalent
+    G4double fEnergyResolution = 0.;        // sigma/L at 1 MeVee, scales as 1/sqrt(L)
+    G4double fTimeResolution = 0.;          // sigma
+
+    G4double fEMin = 1. * keV;
+    G4double fEMax = 200. * MeV;
+    G4double fInvDLogE = 0.;
+    std::vector<G4double> fTable[kNSpecies];
+    G4double fTailSlope[kNSpecies] = {};
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,121 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventCost.hh
+/// \brief Definition of the EventCost class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef EventCost_h
+#define EventCost_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4Track.hh"
+#include "globals.hh"
+
+#include <chrono>
+#include <vector>
+
+class G4Event;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Per-event cost: wall time, steps, tracks and secondaries.
+///
+/// Each event fills the log-binned H1s booked by HistoManager, so the
+/// cost distribution and its tail are merged like any other histogram.
+/// The slowest events of each thread are kept with their primary
+/// kinematics and the engine status stored in the G4Event, and dumped by
+/// the master at end of run so they can be replayed: in paired runs from
+/// the per-event seeds, otherwise from the engine status in a sequential
+/// session (workers reseed every event, so the status cannot be imposed on
+/// one of them).
+
+class EventCost
+{
+  public:
+    struct SlowEvent
+    {
+        G4double        fTime = 0.;     // s
+        G4int           fEventID = -1;
+        G4int           fThread = 0;
+        G4long          fSteps = 0;
+        G4long          fTracks = 0;
+        G4long          fSecondaries = 0;
+        G4String        fParticle;
+        G4double        fEnergy = 0.;
+        G4ThreeVector   fPosition;
+        G4ThreeVector   fDirection;
+        G4double        fT0 = 0.;
+        G4double        fWeight = 1.;
+        G4String        fRandomStatus;  // before GeneratePrimaries
+        G4int           fPairedSeed = 0;
+    };
+
+  public:
+    EventCost() = default;
+    ~EventCost() = default;
+
+    void SetNSlowest(G4int val)     { fNSlowest = val; };
+    // paired runs reseed each event from (seed, eventID + 1)
+    void SetPairedSeed(G4int val)   { fPairedSeed = val; };
+
+    void BeginEvent();
+    // counted once per track, at its end
+    inline void CountTrack(const G4Track* track)
+    {
+        fTracks++;
+        fSteps += track->GetCurrentStepNumber();
+        if (track->GetParentID() > 0) fSecondaries++;
+    }
+    void EndEvent(const G4Event*);
+
+    void Merge(const EventCost&);
+    void Write(const G4String& fileName) const;
+
+  private:
+    G4int fNSlowest = 10;
+    G4int fPairedSeed = 0;
+
+    // current event
+    std::chrono::steady_clock::time_point fStart;
+    G4long fSteps = 0;
+    G4long fTracks = 0;
+    G4long fSecondaries = 0;
+
+    // run totals
+    G4long fNEvents = 0;
+    G4double fSumTime = 0.;
+    G4double fMaxTime = 0.;
+
+    // slowest events, min-heap on fTime
+    std::vector<SlowEvent> fSlowest;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
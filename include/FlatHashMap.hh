@@ -0,0 +1,147 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file FlatHashMap.hh
+/// \brief Definition of the FlatHashMap class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef FlatHashMap_h
+#define FlatHashMap_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// default key -> 64 bit hash, for integer and pointer keys
+template <typename Key>
+struct FlatHash
+{
+    std::uint64_t operator()(const Key& key) const  { return (std::uint64_t)key; }
+};
+
+template <typename T>
+struct FlatHash<T*>
+{
+    std::uint64_t operator()(const T* key) const    { return (std::uint64_t)(std::uintptr_t)key; }
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Open-addressing hash map with linear probing in one flat slot array.
+///
+/// Meant for per-thread counters keyed by small integers or compact
+/// structs: no allocation per entry, no erase, and the table doubles when
+/// half full. Hashes are spread with a Fibonacci multiply, so identity
+/// hashes of clustered keys (PDG codes, indices) still probe well.
+
+template <typename Key, typename Value, typename Hash = FlatHash<Key>>
+class FlatHashMap
+{
+  public:
+    explicit FlatHashMap(std::size_t capacity = 64)  { Reset(capacity); }
+
+    // value for key, default-constructed on first access
+    Value& operator[](const Key& key)
+    {
+        if (2 * (fSize + 1) > fSlots.size()) Grow();
+        std::size_t i = Index(key);
+        while (fSlots[i].fUsed) {
+            if (fSlots[i].fKey == key) return fSlots[i].fValue;
+            i = (i + 1) & fMask;
+        }
+        fSlots[i].fUsed = true;
+        fSlots[i].fKey = key;
+        fSlots[i].fValue = Value();
+        fSize++;
+        return fSlots[i].fValue;
+    }
+
+    template <typename F>
+    void ForEach(F f) const
+    {
+        for (const auto& slot : fSlots) {
+            if (slot.fUsed) f(slot.fKey, slot.fValue);
+        }
+    }
+
+    std::size_t Size() const    { return fSize; };
+    G4bool Empty() const        { return fSize == 0; };
+
+    void Clear()
+    {
+        for (auto& slot : fSlots) slot.fUsed = false;
+        fSize = 0;
+    }
+
+  private:
+    struct Slot
+    {
+        Key     fKey{};
+        Value   fValue{};
+        G4bool  fUsed = false;
+    };
+
+    std::size_t Index(const Key& key) const
+    {
+        return (std::size_t)((Hash()(key) * 0x9E3779B97F4A7C15ull) >> fShift);
+    }
+
+    void Reset(std::size_t capacity)
+    {
+        std::size_t size = 8;
+        G4int bits = 3;
+        while (size < capacity) { size <<= 1; bits++; }
+        fSlots.assign(size, Slot());
+        fMask = size - 1;
+        fShift = 64 - bits;
+        fSize = 0;
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> old;
+        old.swap(fSlots);
+        Reset(2 * old.size());
+        for (const auto& slot : old) {
+            if (slot.fUsed) (*this)[slot.fKey] = slot.fValue;
+        }
+    }
+
+  private:
+    std::vector<Slot> fSlots;
+    std::size_t fMask = 0;
+    G4int fShift = 64;
+    std::size_t fSize = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -17,26 +17,35 @@ class GeometryDetectorPanel
 
     G4int Build();
     G4int PlaceDetector(G4LogicalVolume* expHallLog, G4ThreeVector move, G4RotationMatrix* rotate);
+    // copy number the last imprint gave its scintillator
+    G4int GetScintiCopyNo() const   { return fScintiCopyNo; };
 
     G4LogicalVolume* GetScintiLog() { return fScintiLog; };
+    // volume carrying the sensitive detector: ScintiLog, or PixelLog when pixelated
+    G4LogicalVolume* GetSensitiveLog() { return fPixelLog ? fPixelLog : fScintiLog; };
 
     void SetXY(G4double val)        { fXY = val; };
     void SetZ(G4double val)         { fZ = val; };
+    // n x n pixels replicated inside the scintillator, 0 for one block
+    void SetPixels(G4int val)       { fNPixels = val; };
 
     void BuildMaterials();
 
   private:
     G4AssemblyVolume* fDetectorPanelAssembly;
     G4LogicalVolume* fScintiLog;
+    G4LogicalVolume* fPixelLog = nullptr;
 
     G4double fXY;
     G4double fZ;
+    G4int fNPixels = 0;
 
     G4String fScintiMaterialName;
 
     G4Colour fScintiColour;
 
     G4int fCopyNo;
+    G4int fScintiCopyNo = -1;
 };
 
 #endif
@@ -36,17 +36,52 @@
 #include "G4AnalysisManager.hh"
 #include "globals.hh"
 
+#include "NtupleBuffer.hh"
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class HistoManager
 {
+  public:
+    // ntuple ids, in booking order
+    enum { kTree = 0, kHits, kShield, kCrossing, kNtuples };
+    // H1 ids, in booking order
+    enum { kEp = 0, kEventTime, kEventSteps, kEventTracks, kEventSecondaries };
+    // H2 ids, in booking order
+    enum { kEpTheta = 0, kEpCosTheta, kPanelImage, kPanelImageNEE, kPanelImageTLE };
+    // ntuple output
+    enum { kTTree = 0, kRNTuple };
+
   public:
     HistoManager();
-    ~HistoManager() = default;
+    ~HistoManager();
+
+    // this thread's row buffer for an ntuple
+    static NtupleBuffer* GetBuffer(G4int id)   { return fBuffers[id]; };
+    static void FlushBuffers();
+
+    // false: every worker writes its ntuples to <file>_t<thread>.root with
+    // no locking, for ldrs_merge to join offline; histograms still go to
+    // the master's file. Fixed once the first file is open.
+    void SetNtupleMerging(G4bool);
+
+    // kTTree through the analysis manager, or kRNTuple: typed fields in
+    // <file>_rnt.root, written by RNtupleOutput with a writer per thread
+    void SetBackend(G4int);
+    // open and close this thread's side of the RNTuple output
+    void BeginRun(G4bool master);
+    void EndRun(G4bool master);
 
   private:
     void Book();
+    // the ntuple and its row buffer; returns the ntuple id
+    G4int BookNtuple(const G4String& name, const G4String& title, const std::vector<NtupleBuffer::Column>&);
     G4String fFileName = "hadr03";
+    G4int fBackend = kTTree;
+
+    static G4ThreadLocal NtupleBuffer* fBuffers[kNtuples];
+    // shared: set on the master in PreInit, read by every thread's Book()
+    static G4bool fNtupleMerging;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
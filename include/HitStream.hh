@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file HitStream.hh
+/// \brief Definition of the HitStream class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef HitStream_h
+#define HitStream_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class HitStreamMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Cross-event pile-up and dead time of the panel channels.
+///
+/// Each event is given a beam-time offset from a pulse structure: events
+/// are grouped eventsPerPulse to a pulse, pulses repeat with a period, and
+/// an event starts at a uniform time within the pulse width (drawn from a
+/// hash of the event ID, so the physics random sequence is untouched).
+/// PanelSD appends the accepted hits, at their beam time, to the Buffer of
+/// its thread's Run.
+///
+/// At end of run the master sorts the buffers of all threads in parallel,
+/// merges them into one time-ordered stream (k-way merge) and runs every
+/// channel (panel, or panel and pixel) through a dead time, paralyzable or
+/// not, with pile-up: hits within the pile-up window of a counted pulse add
+/// their light to it. The counted pulses are written to a ROOT tree.
+
+class HitStream
+{
+  public:
+    struct Record
+    {
+        G4double    fTime;      // beam time
+        G4float     fLight;     // light (or deposited energy) of the hit
+        G4int       fPanel;
+        G4int       fPixel;     // -1 on a monolithic panel
+    };
+
+    // one thread's hits, filled by the sensitive detector
+    class Buffer
+    {
+      public:
+        void Configure(const HitStream&);
+        G4bool IsActive() const     { return fRecords != nullptr; };
+
+        void BeginEvent(G4int eventID);
+        G4double GetOffset() const  { return fOffset; };
+        inline void Add(G4int panel, G4int pixel, G4double time, G4double light)
+        {
+            fRecords->push_back(Record{fOffset + time, (G4float)light, panel, pixel});
+        }
+
+        // keeps a reference to the other thread's records
+        void Merge(const Buffer&);
+
+      private:
+        friend class HitStream;
+        G4double fPeriod = 0.;
+        G4double fWidth = 0.;
+        G4int fEventsPerPulse = 1;
+        G4double fOffset = 0.;
+        std::shared_ptr<std::vector<Record>> fRecords;
+        std::vector<std::shared_ptr<std::vector<Record>>> fParts;   // master
+    };
+
+  public:
+    HitStream();
+    ~HitStream();
+
+    void SetActive(G4bool val)                  { fActive = val; };
+    void SetPulse(G4double period, G4double width, G4int eventsPerPulse)
+    {
+        fPeriod = period;
+        fWidth = width;
+        fEventsPerPulse = eventsPerPulse;
+    }
+    void SetDeadTime(G4double val)              { fDeadTime = val; };
+    void SetParalyzable(G4bool val)             { fParalyzable = val; };
+    void SetPileUpWindow(G4double val)          { fPileUpWindow = val; };
+    void SetPixelChannels(G4bool val)           { fPixelChannels = val; };
+    void SetFileName(const G4String& val)       { fFileName = val; };
+    G4bool IsActive() const                     { return fActive; };
+
+    // master, end of run: merge the thread streams, count and write
+    void Process(Buffer&) const;
+
+  private:
+    HitStreamMessenger* fMessenger = nullptr;
+
+    G4bool fActive = false;
+    G4double fPeriod;
+    G4double fWidth;
+    G4int fEventsPerPulse = 1;
+    G4double fDeadTime = 0.;
+    G4bool fParalyzable = false;
+    G4double fPileUpWindow = 0.;
+    G4bool fPixelChannels = true;
+    G4String fFileName = "stream.root";
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,93 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImageCube.hh
+/// \brief Definition of the ImageCube class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ImageCube_h
+#define ImageCube_h 1
+
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Time-of-flight resolved image: dense (x, y, t) cube of panel hits,
+/// optionally weighted, in single precision to keep one copy per thread
+/// affordable (100 x 100 x 700 bins: 28 MB).
+///
+/// PanelSD fills the cube of its thread's Run at end of event. Run::Merge
+/// only keeps a reference to each worker's array; the master adds them
+/// by a pairwise tree reduction over threads just before writing, so the
+/// merge costs log2(threads) passes instead of one serial pass per worker.
+
+class ImageCube
+{
+  public:
+    ImageCube() = default;
+    ~ImageCube() = default;
+
+    void Configure(G4int nx, G4int ny, G4int nt, G4double xlo, G4double xhi, G4double ylo, G4double yhi,
+                   G4double tlo, G4double thi, G4bool weighted);
+    G4bool IsConfigured() const     { return fData != nullptr; };
+
+    inline void Fill(G4double x, G4double y, G4double t, G4double weight)
+    {
+        G4int ix = (G4int)((x - fXLo) * fInvX);
+        G4int iy = (G4int)((y - fYLo) * fInvY);
+        G4int it = (G4int)((t - fTLo) * fInvT);
+        if (x < fXLo || ix >= fN[0] || y < fYLo || iy >= fN[1] || t < fTLo || it >= fN[2]) return;
+        (*fData)[((std::size_t)it * fN[1] + iy) * fN[0] + ix] += fWeighted ? (float)weight : 1.f;
+    }
+
+    void Merge(const ImageCube&);
+
+    // master: reduce the worker cubes, then one TH3F in (x, y, ToF) and,
+    // for a flight path > 0, one in (x, y, neutron energy)
+    void Write(const G4String& fileName, G4double flightPath);
+
+  private:
+    void Reduce();
+
+  private:
+    G4int fN[3] = {0, 0, 0};
+    G4double fXLo = 0., fXHi = 0., fInvX = 0.;
+    G4double fYLo = 0., fYHi = 0., fInvY = 0.;
+    G4double fTLo = 0., fTHi = 0., fInvT = 0.;
+    G4bool fWeighted = true;
+
+    std::shared_ptr<std::vector<float>> fData;                  // [it][iy][ix]
+    std::vector<std::shared_ptr<std::vector<float>>> fParts;    // master: worker cubes
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
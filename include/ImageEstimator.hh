@@ -0,0 +1,149 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImageEstimator.hh
+/// \brief Definition of the ImageEstimator class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ImageEstimator_h
+#define ImageEstimator_h 1
+
+#include "G4RotationMatrix.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+class DetectorConstruction;
+class ImageEstimatorMessenger;
+class PixelImage;
+class G4LogicalVolume;
+class G4Navigator;
+class G4Step;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Variance-reduced neutron images of the panels, scored into the
+/// PixelImage next to the analog hit tally.
+///
+/// Next-event (point detector): at every neutron elastic collision each
+/// pixel is scored with the density of scattering towards its centre (target
+/// at rest, isotropic in the centre of mass), its solid angle and the
+/// uncollided transmission exp(-tau) along the ray, tau from the total
+/// neutron cross sections of the materials crossed. The ray is traced once
+/// per panel, to its centre, at the energy scattered that way. Within the
+/// exclusion radius the 1/R^2 is capped: a small bias for a finite variance.
+///
+/// Track-length: weight x step length / thickness of the neutron steps in
+/// the panel.
+///
+/// Both estimate the neutron fluence on the panel integrated over the face
+/// of each pixel, i.e. crossings per pixel at normal incidence. A monolithic
+/// panel is imaged on a grid of its own.
+
+class ImageEstimator
+{
+  public:
+    // per-thread ray tracing through the geometry, owned by SteppingAction
+    class Tracer
+    {
+      public:
+        Tracer();
+        ~Tracer();
+
+        // neutron optical depth from one point to another, stopping past maxDepth
+        G4double OpticalDepth(const G4ThreeVector& from, const G4ThreeVector& to,
+                              G4double energy, G4double maxDepth);
+
+      private:
+        std::unique_ptr<G4Navigator> fNavigator;
+        std::vector<G4double> fSigma;   // per material index, at fEnergy; < 0 not computed
+        G4double fEnergy = -1.;
+    };
+
+  public:
+    ImageEstimator(DetectorConstruction*);
+    ~ImageEstimator();
+
+    void SetNextEvent(G4bool val)           { fNextEvent = val; };
+    void SetTrackLength(G4bool val)         { fTrackLength = val; };
+    void SetExclusionRadius(G4double val)   { fExclusionRadius = val; };
+    void SetGrid(G4int val)                 { fGrid = val; };
+    G4bool IsNextEvent() const              { return fNextEvent; };
+    G4bool IsTrackLength() const            { return fTrackLength; };
+    G4bool IsActive() const                 { return fNextEvent || fTrackLength; };
+
+    // panel frames and pixel centres; master, at begin of run
+    void Resolve();
+    // image pixels per side: the panel's, or the grid of a monolithic panel
+    G4int GetNPixels() const                { return fN; };
+
+    void ScoreCollision(const G4Step*, Tracer&, PixelImage*) const;
+    void ScoreTrack(const G4Step*, PixelImage*) const;
+
+    // lab-frame density per steradian of elastic scattering by cos(theta) =
+    // mu off a target of mass ratio a at rest, isotropic in the centre of
+    // mass; fraction is the energy kept by the neutron
+    static G4double AngularDensity(G4double mu, G4double a, G4double& fraction);
+
+  private:
+    struct Panel
+    {
+        G4RotationMatrix fToLocal;
+        G4ThreeVector fTranslation;
+        G4ThreeVector fCentre;                  // of the front face, world frame
+        std::vector<G4ThreeVector> fPixels;     // pixel centres on the front face
+    };
+
+  private:
+    static constexpr G4double kMaxDepth = 30.;  // exp(-30): nothing to score
+
+    ImageEstimatorMessenger* fMessenger = nullptr;
+    DetectorConstruction* fDetector = nullptr;
+
+    G4bool fNextEvent = false;
+    G4bool fTrackLength = false;
+    G4double fExclusionRadius = 1. * CLHEP::cm;
+    G4int fGrid = 40;
+
+    G4int fN = 0;
+    G4bool fPixelated = false;
+    G4double fHalfXY = 0.;
+    G4double fPitch = 0.;
+    G4double fThickness = 0.;
+    G4double fFront = 0.;                       // front face, panel frame
+    const G4LogicalVolume* fSensitiveLog = nullptr;
+    std::vector<Panel> fPanels;
+    std::vector<G4int> fPanelOfCopy;            // scintillator copy number -> fPanels index
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,137 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImportanceBiasing.hh
+/// \brief Definition of the ImportanceBiasing class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ImportanceBiasing_h
+#define ImportanceBiasing_h 1
+
+#include "G4LogicalVolume.hh"
+#include "G4StepPoint.hh"
+#include "G4ThreeVector.hh"
+#include "G4NavigationHistory.hh"
+#include "G4VTouchable.hh"
+#include "G4VPhysicalVolume.hh"
+#include "globals.hh"
+
+#include <algorithm>
+#include <vector>
+
+class BiasingMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Geometry-importance splitting and Russian roulette.
+///
+/// A biased layer is a logical volume name (e.g. PbLog, BoratedPELog) whose
+/// volumes, e.g. in both the collimator and the shielding, are cut into
+/// cells by depth: for a shell built as a subtraction of two boxes, depth
+/// runs from the outer surface to the cavity, otherwise from the surface
+/// to the centre. Importances grow geometrically from the outer to the
+/// inner cell.
+///
+/// The track weight carries the importance of the last cell it was in
+/// (w = 1/I), so at each step ending in a biased cell the stepping action
+/// compares I*w with 1: above, the track is split; below, it is
+/// Russian-rouletted; survivors and copies leave with weight 1/I.
+
+class ImportanceBiasing
+{
+  public:
+    // one logical volume of a layer, with its own walls
+    struct Volume
+    {
+        const G4LogicalVolume*  fLogical = nullptr;
+        G4ThreeVector           fCenter;
+        G4ThreeVector           fHalf;
+        G4ThreeVector           fThickness;     // 0 along axes without a wall
+    };
+
+    struct Layer
+    {
+        G4String                fName;
+        G4int                   fNCells = 1;
+        G4double                fOuter = 1.;    // importance of the outer cell
+        G4double                fInner = 1.;    // importance of the inner cell
+        std::vector<G4double>   fImportance;
+        // resolved
+        std::vector<Volume>     fVolumes;
+    };
+
+  public:
+    ImportanceBiasing();
+    ~ImportanceBiasing();
+
+    void SetLayer(const G4String& name, G4int nCells, G4double outer, G4double inner);
+    void SetMaxSplit(G4int val)     { fMaxSplit = val; };
+    void Clear();
+    void List() const;
+
+    // find the logical volumes and their walls; master, at begin of run
+    void Resolve();
+
+    G4bool IsEmpty() const          { return fLayers.empty(); };
+    G4int GetMaxSplit() const       { return fMaxSplit; };
+
+    // importance of the cell containing the point, 0 outside biased layers
+    inline G4double Importance(const G4StepPoint* point) const
+    {
+        const G4VPhysicalVolume* volume = point->GetPhysicalVolume();
+        if (!volume) return 0.;
+        const G4LogicalVolume* logical = volume->GetLogicalVolume();
+        for (const auto& layer : fLayers) {
+            for (const auto& cells : layer.fVolumes) {
+                if (cells.fLogical != logical) continue;
+                if (layer.fImportance.size() == 1) return layer.fImportance[0];
+                G4ThreeVector local = point->GetTouchable()->GetHistory()->GetTopTransform()
+                                            .TransformPoint(point->GetPosition()) - cells.fCenter;
+                G4double depth = 1.;
+                for (G4int i = 0; i < 3; i++) {
+                    if (cells.fThickness[i] <= 0.) continue;
+                    depth = std::min(depth, (cells.fHalf[i] - std::abs(local[i])) / cells.fThickness[i]);
+                }
+                G4int n = layer.fImportance.size();
+                G4int cell = std::min(std::max((G4int)(depth * n), 0), n - 1);
+                return layer.fImportance[cell];
+            }
+        }
+        return 0.;
+    }
+
+  private:
+    BiasingMessenger* fMessenger = nullptr;
+
+    std::vector<Layer> fLayers;
+    G4int fMaxSplit = 100;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file KillZoneMessenger.hh
+/// \brief Definition of the KillZoneMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef KillZoneMessenger_h
+#define KillZoneMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class KillZones;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class KillZoneMessenger : public G4UImessenger
+{
+  public:
+    KillZoneMessenger(KillZones*);
+    ~KillZoneMessenger() override;
+
+    void SetNewValue(G4UIcommand*, G4String) override;
+
+  private:
+    KillZones* fZones = nullptr;
+
+    G4UIdirectory*              fDir = nullptr;
+    G4UIcommand*                fAddBoxCmd = nullptr;
+    G4UIcommand*                fAddCylinderCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fOutsideComponentsCmd = nullptr;
+    G4UIcmdWithoutParameter*    fClearCmd = nullptr;
+    G4UIcmdWithoutParameter*    fListCmd = nullptr;
+    G4UIcmdWithABool*           fCullCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit*  fCullMarginCmd = nullptr;
+    G4UIcmdWithADouble*         fCullSurvivalCmd = nullptr;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
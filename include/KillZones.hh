@@ -0,0 +1,167 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file KillZones.hh
+/// \brief Definition of the KillZones class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef KillZones_h
+#define KillZones_h 1
+
+#include "DetectorConstruction.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class KillZoneMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Regions of the world where tracks are stopped as soon as they step in.
+///
+/// Zones are world-frame boxes, z-aligned cylinders, or everything outside
+/// the bounding box of the placed components grown by a margin. The last
+/// kind depends on what has been placed, so it is computed in Resolve() at
+/// the start of each run.
+///
+/// Optionally, neutrals leaving the placed components into world air are
+/// culled when their straight line misses every detector panel (grown by a
+/// margin). Crossings into the air between or inside components (the
+/// shielding cavity) are left alone. Culled neutrals are killed outright,
+/// or Russian-rouletted with a survival probability so that scatter back
+/// towards the panel stays unbiased.
+
+class KillZones
+{
+  public:
+    enum { kBox = 0, kCylinder, kOutside };
+
+    struct Zone
+    {
+        G4int           fShape;
+        G4ThreeVector   fCenter;
+        G4ThreeVector   fHalf;          // box half lengths, cylinder half z
+        G4double        fRadius = 0.;
+        G4double        fMargin = 0.;
+        G4ThreeVector   fLo;            // resolved bounds of the kOutside box
+        G4ThreeVector   fHi;
+    };
+
+  public:
+    KillZones(DetectorConstruction*);
+    ~KillZones();
+
+    void AddBox(const G4ThreeVector& center, const G4ThreeVector& half);
+    void AddCylinder(const G4ThreeVector& center, G4double radius, G4double halfZ);
+    void AddOutsideComponents(G4double margin);
+    void Clear();
+    void List() const;
+    // one line description of a zone, for the listing and the run summary
+    G4String Describe(std::size_t zone) const;
+
+    // bounding box of the placed components for kOutside zones
+    void Resolve();
+
+    G4bool IsEmpty() const  { return fZones.empty(); };
+
+    // directional culling of neutrals
+    void SetCulling(G4bool val)             { fCulling = val; };
+    void SetCullMargin(G4double val)        { fCullMargin = val; };
+    void SetCullSurvival(G4double val)      { fCullSurvival = val; };
+    G4bool IsCulling() const                { return fCulling; };
+    G4double GetCullSurvival() const        { return fCullSurvival; };
+
+    // true if a straight line from pos along dir misses every panel
+    inline G4bool MissesPanels(const G4ThreeVector& pos, const G4ThreeVector& dir) const
+    {
+        for (const auto& panel : fPanels) {
+            G4ThreeVector p = panel.fInvRotation * (pos - panel.fTranslation);
+            G4ThreeVector d = panel.fInvRotation * dir;
+            G4double tmin, tmax;
+            if (DetectorConstruction::IntersectBox(p, d, panel.fLo, panel.fHi, tmin, tmax)) return false;
+        }
+        return true;
+    }
+
+    // true unless pos is strictly inside the outer box of a placed
+    // component; a point on the face just left counts as outside
+    inline G4bool OutsideComponents(const G4ThreeVector& pos) const
+    {
+        const G4double tol = kSurfaceTolerance;
+        for (const auto& ext : fComponents) {
+            G4ThreeVector p = ext.fInvRotation * (pos - ext.fTranslation);
+            if (p.x() > ext.fLo.x() + tol && p.x() < ext.fHi.x() - tol &&
+                p.y() > ext.fLo.y() + tol && p.y() < ext.fHi.y() - tol &&
+                p.z() > ext.fLo.z() + tol && p.z() < ext.fHi.z() - tol) return false;
+        }
+        return true;
+    }
+
+    // index of the first zone containing pos, -1 if none
+    inline G4int Find(const G4ThreeVector& pos) const
+    {
+        for (std::size_t i = 0; i < fZones.size(); i++) {
+            const Zone& zone = fZones[i];
+            if (zone.fShape == kOutside) {
+                if (pos.x() < zone.fLo.x() || pos.x() > zone.fHi.x() ||
+                    pos.y() < zone.fLo.y() || pos.y() > zone.fHi.y() ||
+                    pos.z() < zone.fLo.z() || pos.z() > zone.fHi.z()) return i;
+                continue;
+            }
+            G4ThreeVector d = pos - zone.fCenter;
+            if (std::abs(d.z()) > zone.fHalf.z()) continue;
+            if (zone.fShape == kBox) {
+                if (std::abs(d.x()) <= zone.fHalf.x() && std::abs(d.y()) <= zone.fHalf.y()) return i;
+            }
+            else if (d.x()*d.x() + d.y()*d.y() <= zone.fRadius*zone.fRadius) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+  private:
+    DetectorConstruction* fDetector = nullptr;
+    KillZoneMessenger* fMessenger = nullptr;
+
+    std::vector<Zone> fZones;
+
+    G4bool fCulling = false;
+    G4double fCullMargin = 0.;
+    G4double fCullSurvival = 0.;    // 0: kill, else roulette survival probability
+    std::vector<DetectorConstruction::Extent> fPanels;  // grown by fCullMargin
+    std::vector<DetectorConstruction::Extent> fComponents;
+    static constexpr G4double kSurfaceTolerance = 1. * CLHEP::um;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
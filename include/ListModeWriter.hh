@@ -0,0 +1,125 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ListModeWriter.hh
+/// \brief Definition of the ListModeWriter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ListModeWriter_h
+#define ListModeWriter_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+class ListModeMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// List-mode output of the panel hits: one binary file per thread and run,
+/// <stem>_r<run>_t<thread>.lmd, made of fixed-width 12-byte records in host
+/// (little-endian) byte order after a 48-byte header.
+///
+/// Each event with hits starts with a marker record (species and panel
+/// 0xFF) holding the event ID and the event's beam time in ns (48 bits,
+/// 0 without the hit stream). Hit records follow, with the time as a signed
+/// delta, in ticks, from the previous record of the event (the marker at
+/// time 0); the pixel column and row, or x and y quantized around 0; the
+/// light (or deposited energy) in 16 bits; a species code and the panel.
+///
+/// Records are staged in a per-thread buffer and written in large blocks.
+/// Every indexStride-th marker goes into <stem>_r<run>_t<thread>.idx as
+/// (event ID, byte offset), so a reader can seek to any event.
+
+class ListModeWriter
+{
+  public:
+    enum { kOther = 0, kElectron, kGamma, kProton, kDeuteron, kTriton, kHelium, kIon, kMarker = 0xFF };
+
+    struct Record
+    {
+        std::int32_t    fDelta;     // ticks since the previous record; event ID in markers
+        std::uint16_t   fX;         // column, or x / quantum + 32768
+        std::uint16_t   fY;         // row, or y / quantum + 32768
+        std::uint16_t   fEnergy;    // light / LSB
+        std::uint8_t    fSpecies;
+        std::uint8_t    fPanel;
+    };
+    static_assert(sizeof(Record) == 12, "list-mode records are 12 bytes");
+
+  public:
+    ListModeWriter();
+    ~ListModeWriter();
+
+    void SetActive(G4bool val)                  { fActive = val; };
+    void SetFileStem(const G4String& val)       { fFileStem = val; };
+    void SetTimeTick(G4double val)              { fTick = val; };
+    void SetPositionQuantum(G4double val)       { fQuantum = val; };
+    void SetEnergyLSB(G4double val)             { fEnergyLSB = val; };
+    void SetIndexStride(G4int val)              { fIndexStride = val; };
+    G4bool IsOpen() const                       { return fOut.is_open(); };
+
+    // worker, begin and end of run
+    void Open(G4int runID, G4int nPixels);
+    void Close();
+
+    void Add(G4int eventID, G4double beamTime, G4int panel, G4int pixel, const G4ThreeVector& pos,
+             G4double time, G4double light, G4int pdg);
+
+  private:
+    void Put(const Record&);
+    void Flush();
+    static std::uint8_t Species(G4int pdg);
+
+  private:
+    ListModeMessenger* fMessenger = nullptr;
+
+    G4bool fActive = false;
+    G4String fFileStem = "listmode";
+    G4double fTick;
+    G4double fQuantum;
+    G4double fEnergyLSB;
+    G4int fIndexStride = 1000;
+
+    std::ofstream fOut;
+    G4String fFileName;
+    G4int fNPixels = 0;
+    std::vector<Record> fBuffer;
+    std::vector<std::int64_t> fIndex;   // event ID, byte offset pairs
+    std::uint64_t fNRecords = 0;
+    std::uint64_t fNMarkers = 0;
+    G4int fEvent = -1;
+    std::int64_t fLastTick = 0;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
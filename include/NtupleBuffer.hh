@@ -0,0 +1,105 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NtupleBuffer.hh
+/// \brief Definition of the NtupleBuffer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef NtupleBuffer_h
+#define NtupleBuffer_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Per-thread columnar row buffer for one ntuple.
+///
+/// Scorers append rows with plain stores into one contiguous array per
+/// column; the rows are handed to the analysis manager in one block when the
+/// buffer is full or when Flush() is called at the end of the run, or to
+/// RNtupleOutput when the RNTuple backend is selected.
+
+class NtupleBuffer
+{
+  public:
+    // storage of a column: the TTree backend books kInt as I and the rest
+    // as D; kCode (PDG codes) is an int32 field in the RNTuple backend but
+    // stays a D column in the TTree, as the analysis macros read it
+    enum Type { kDouble = 0, kFloat, kInt, kCode };
+    struct Column
+    {
+        G4String fName;
+        Type fType;
+    };
+
+  public:
+    NtupleBuffer(G4int ntupleId, const G4String& name, const std::vector<Column>& columns,
+                 std::size_t capacity = 4096);
+    ~NtupleBuffer() = default;
+
+    // rows go to this thread's RNtupleOutput writer instead of the analysis manager
+    void SetRNtuple(G4bool val)     { fRNtuple = val; };
+
+    // index of the next free row, flushing first if the buffer is full
+    inline std::size_t NextRow()
+    {
+        if (fRows == fCapacity) Flush();
+        return fRows++;
+    }
+
+    inline void Set(G4int col, std::size_t row, G4double val)
+    {
+        fData[col * fCapacity + row] = val;
+    }
+
+    void Flush();
+
+    G4int GetNtupleId() const       { return fNtupleId; };
+    const G4String& GetName() const { return fName; };
+    const std::vector<Column>& GetColumns() const   { return fColumns; };
+    std::size_t GetNRows() const    { return fRows; };
+    G4int GetNColumns() const       { return fNColumns; };
+    const G4double* GetColumn(G4int col) const  { return &fData[col * fCapacity]; };
+
+  private:
+    G4int fNtupleId;
+    G4String fName;
+    std::vector<Column> fColumns;
+    G4int fNColumns;
+    std::size_t fCapacity;
+    std::size_t fRows = 0;
+    G4bool fRNtuple = false;
+
+    std::vector<G4double> fData;    // fNColumns x fCapacity, column major
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -67,13 +67,19 @@ class PanelHit : public G4VHit
         void SetPos(G4ThreeVector xyz) { fPos = xyz; };
         void SetTime(G4double t) { fTime = t; };
         void SetPID(G4int pid) { fPID = pid; };
+        void SetWeight(G4double w) { fWeight = w; };
+        void SetPixel(G4int pixel) { fPixel = pixel; };
+        void SetPanel(G4int panel) { fPanel = panel; };
 
         // Get methods
         G4int GetTrackID() const { return fTrackID; };
         G4double GetEdep() const { return fEdep; };
-        G4ThreeVector GetPos() const { return fPos; };
+        const G4ThreeVector& GetPos() const { return fPos; };
         G4double GetTime() const { return fTime; };
         G4int GetPID() const { return fPID; };
+        G4double GetWeight() const { return fWeight; };
+        G4int GetPixel() const { return fPixel; };
+        G4int GetPanel() const { return fPanel; };
 
     private:
         G4int           fTrackID = -1;
@@ -81,6 +87,9 @@ class PanelHit : public G4VHit
         G4ThreeVector   fPos;
         G4double        fTime = 0.;
         G4int           fPID = -1;
+        G4double        fWeight = 1.;
+        G4int           fPixel = -1;        // row * n + column, -1 on a monolithic panel
+        G4int           fPanel = 0;         // placement order of the panel
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
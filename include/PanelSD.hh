@@ -31,12 +31,15 @@
 #define PanelSD_h 1
 
 #include "PanelHit.hh"
+#include "Digitizer.hh"
+#include "FlatHashMap.hh"
 
 #include "G4VSensitiveDetector.hh"
 
 #include <vector>
 
 class G4Step;
+class TrackingAction;
 class G4HCofThisEvent;
 
 /// Tracker sensitive detector class
@@ -56,9 +59,43 @@ class PanelSD : public G4VSensitiveDetector
     G4bool ProcessHits(G4Step* step, G4TouchableHistory* history) override;
     void EndOfEvent(G4HCofThisEvent* hitCollection) override;
 
+    // n x n pixels over the panel XY, 0 for a monolithic panel
+    void SetPixels(G4int n);
+    void SetHitRows(G4bool val)     { fHitRows = val; };
+    void SetDigitizer(const Digitizer* val)     { fDigitizer = val; };
+
+  private:
+    // first hit of the event in one pixel (or monolithic panel)
+    struct HitSlot
+    {
+        G4double        fTime = DBL_MAX;
+        G4double        fEdep = 0.;
+        G4ThreeVector   fPos;
+        G4int           fTrackID = -1;
+        G4int           fPID = -1;
+        G4double        fWeight = 1.;
+    };
+
   private:
     PanelHitsCollection* fHitsCollection = nullptr;
-    G4bool fTrig = false;
+    G4bool fHitRows = true;
+
+    // slots indexed by panel * fSlotsPerPanel + pixel, grown as panels are
+    // hit; only the touched ones are reset at end of event
+    G4int fNPixels = 0;
+    G4int fSlotsPerPanel = 1;
+    std::vector<HitSlot> fSlots;
+    std::vector<G4int> fTouched;
+
+    // split copies and their descendants fill slots of their own, keyed by
+    // (branch << 32 | slot index), so each branch is one hit with its own weight
+    const TrackingAction* fTracking = nullptr;
+    FlatHashMap<std::int64_t, HitSlot> fBranchSlots;
+
+    const Digitizer* fDigitizer = nullptr;
+    Digitizer::Batch fBatch;
+
+    void AddHit(G4int index, const HitSlot& slot);
 };
 
 
@@ -34,17 +34,23 @@
 #include "G4VModularPhysicsList.hh"
 #include "globals.hh"
 
+class DetectorConstruction;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class PhysicsList : public G4VModularPhysicsList
 {
   public:
-    PhysicsList();
+    PhysicsList(const DetectorConstruction* det);
     ~PhysicsList() = default;
 
   public:
     void ConstructParticle() override;
+    void ConstructProcess() override;
     void SetCuts() override;
+
+  private:
+    const DetectorConstruction* fDetector = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,91 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PixelImage.hh
+/// \brief Definition of the PixelImage class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef PixelImage_h
+#define PixelImage_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Dense n x n image of a pixelated panel: weighted hit count and summed
+/// energy per pixel, indexed row * n + column.
+///
+/// Each thread's Run is filled by PanelSD at end of event; Run::Merge
+/// adds them and the master copies the result into the hPanelImage H2,
+/// so image runs do not need the hits ntuple. With several panels the
+/// pixels of all of them are summed, as in a stack.
+///
+/// Next to the analog tally it holds the ImageEstimator images, on the
+/// same pixels (or the estimator grid of a monolithic panel).
+
+class PixelImage
+{
+  public:
+    enum { kNextEvent = 0, kTrackLength, kNEstimators };
+
+  public:
+    PixelImage() = default;
+    ~PixelImage() = default;
+
+    // n pixels per side over [-halfXY, halfXY] in the panel frame
+    void Configure(G4int n, G4double halfXY);
+    G4bool IsConfigured() const     { return fN > 0; };
+
+    inline void Fill(G4int pixel, G4double weight, G4double edep)
+    {
+        fCounts[pixel] += weight;
+        fEdep[pixel] += weight * edep;
+    }
+    inline void Score(G4int estimator, G4int pixel, G4double value)
+    {
+        fEstimate[estimator][pixel] += value;
+    }
+
+    void Merge(const PixelImage&);
+    // master: into an H2 booked with the same binning
+    void FillH2(G4int id) const;
+    void FillH2(G4int id, G4int estimator) const;
+
+  private:
+    G4int fN = 0;
+    G4double fHalfXY = 0.;
+    std::vector<G4double> fCounts;
+    std::vector<G4double> fEdep;
+    std::vector<G4double> fEstimate[kNEstimators];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -66,6 +66,16 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 
     void SetNeutronPhaseSpace(std::shared_ptr<THnSparseD>);
 
+    // analytic transport of source neutrons through world air
+    void SetTransportMode(G4String);
+
+    // paired (sample in / open beam) runs
+    void SetPairedSeed(G4int);
+    G4int GetPairedSeed() const     { return fPairedSeed; };
+
+  private:
+    G4double TransportToBoundary(G4ThreeVector& pos, const G4ThreeVector& dir, G4double ekin, G4double& time);
+
   private:
     G4ParticleGun* fParticleGun = nullptr;
     G4GeneralParticleSource* fGPS;
@@ -76,6 +86,12 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 
     G4bool fUseNeutronPhaseSpace;
     std::shared_ptr<THnSparseD> fhNeutronPhaseSpace;
+
+    // 0 = none, 1 = uncollided air transmission as weight
+    G4int fTransportMode = 0;
+
+    // > 0: each event is reseeded from (fPairedSeed, eventID)
+    G4int fPairedSeed = 0;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RNtupleOutput.hh
+/// \brief Definition of the RNtupleOutput class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef RNtupleOutput_h
+#define RNtupleOutput_h 1
+
+#include "globals.hh"
+
+class NtupleBuffer;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// RNTuple backend of the buffered ntuples (/LDRS/run/setNtupleBackend).
+///
+/// The master opens <file>_rnt.root next to the analysis file, with one
+/// RNTupleParallelWriter per ntuple whose fields are typed from the buffer
+/// columns: int32 codes and indices, float kinematics, double times. Each
+/// filling thread then creates its own fill context per ntuple, so rows are
+/// packed and compressed into that thread's page buffers and only the
+/// commit of a full cluster is serialised. ntuple_compat.C reads the result
+/// in the analysis macros.
+///
+/// The ROOT RNTuple headers stay in the implementation; without a ROOT that
+/// has the parallel writer (6.34) and the ROOTNTuple library, IsAvailable()
+/// is false and the TTree backend is kept.
+
+class RNtupleOutput
+{
+  public:
+    static G4bool IsAvailable();
+
+    // master, begin of run, before any worker starts
+    static G4bool Open(const G4String& fileName, NtupleBuffer* const buffers[], G4int n);
+    // each filling thread, after Open: its fill contexts, and the buffers
+    // switched over to them
+    static void Attach(NtupleBuffer* const buffers[], G4int n);
+    static void Fill(const NtupleBuffer&);
+    // each filling thread, end of run: its last clusters
+    static void Detach(NtupleBuffer* const buffers[], G4int n);
+    // master, end of run, once every thread has detached
+    static void Close();
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -8,6 +8,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <vector>
 
 class RootManager {
 public:
@@ -20,6 +21,10 @@ public:
     void SampleEvent(Double_t* values);
     bool IsInitialized() const { return fInitialized; }
 
+    // draw from the Geant4 engine instead of gRandom, so that the sampled
+    // primaries follow the per-event Geant4 seeds (paired runs)
+    void SetUseGeant4Engine(bool val) { fUseGeant4Engine = val; }
+
     void SetFileNum(int num) { fFileNum = num;  }
     int  GetFileNum()        { return fFileNum; }
 
@@ -28,6 +33,8 @@ public:
 
 private:
     RootManager();
+
+    void BuildThreadLocalCdf();
     ~RootManager();
     
     RootManager(const RootManager&) = delete;
@@ -42,6 +49,11 @@ private:
     static thread_local std::unique_ptr<THnSparseD> fThreadLocalSparse;
     static thread_local std::unique_ptr<TRandom3> fThreadLocalRandom;
 
+    // cumulative content of the filled bins, for sampling with G4UniformRand
+    static thread_local std::vector<Double_t> fThreadLocalCdf;
+    static thread_local std::vector<Long64_t> fThreadLocalBins;
+    std::atomic<bool> fUseGeant4Engine{false};
+
     int fFileNum = -1;
 };
 
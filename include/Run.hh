@@ -37,18 +37,65 @@
 #include "G4VProcess.hh"
 #include "globals.hh"
 
+#include "FlatHashMap.hh"
+#include "StepProfile.hh"
+#include "VoxelMap.hh"
+#include "EventCost.hh"
+#include "WeightWindows.hh"
+#include "PixelImage.hh"
+#include "ImageCube.hh"
+#include "HitStream.hh"
+
 #include <map>
+#include <vector>
 
 class DetectorConstruction;
 class G4ParticleDefinition;
 class G4HadronicProcessStore;
 class G4Material;
 class G4Element;
+class ListModeWriter;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class Run : public G4Run
 {
+  public:
+    // nuclear channel: projectile + target isotope --> product species,
+    // kept as integers so that counting never builds a string
+    static const G4int kMaxSpecies = 8;
+    struct ChannelKey
+    {
+        G4int fProjectile = 0;              // PDG code
+        G4int fTarget = 0;                  // G4Isotope index + 1, 0 if unknown
+        G4int fNSpecies = 0;
+        G4int fPDG[kMaxSpecies] = {};       // ascending PDG codes
+        G4int fCount[kMaxSpecies] = {};     // multiplicities (gamma or e-: 1)
+
+        G4bool operator==(const ChannelKey& other) const
+        {
+            if (fProjectile != other.fProjectile || fTarget != other.fTarget
+                    || fNSpecies != other.fNSpecies) return false;
+            for (G4int i = 0; i < fNSpecies; i++) {
+                if (fPDG[i] != other.fPDG[i] || fCount[i] != other.fCount[i]) return false;
+            }
+            return true;
+        }
+    };
+
+    struct ChannelHash
+    {
+        std::uint64_t operator()(const ChannelKey& key) const
+        {
+            std::uint64_t h = (std::uint64_t)(std::uint32_t)key.fProjectile * 1000003u + key.fTarget;
+            for (G4int i = 0; i < key.fNSpecies; i++) {
+                h = (h ^ (std::uint32_t)key.fPDG[i]) * 0x100000001B3ull;
+                h = (h ^ key.fCount[i]) * 0x100000001B3ull;
+            }
+            return h;
+        }
+    };
+
   public:
     Run(DetectorConstruction*);
     ~Run() override = default;
@@ -56,17 +103,50 @@ class Run : public G4Run
   public:
     void SetPrimary(G4ParticleDefinition* particle, G4double energy);
     void SetTargetXXX(G4bool);
-    void CountProcesses(G4VProcess* process);
+    void CountProcesses(const G4VProcess* process);
     void SumTrack(G4double);
-    void CountNuclearChannel(G4String, G4double);
-    void ParticleCount(G4String, G4double);
+    void CountNuclearChannel(const ChannelKey&, G4double);
+    void ParticleCount(G4int pdg, G4double);
     void Balance(G4double);
     void CountGamma(G4int);
+    // an interaction with more than kMaxSpecies product species; the rest
+    // are left out of its ChannelKey
+    void CountSpeciesOverflow()         { fNSpeciesOverflow++; };
+    // by kill zone index and particle kind
+    enum { kKillNeutron = 0, kKillGamma, kKillElectron, kKillOther, kNKillKinds };
+    inline void CountKill(G4int zone, G4int kind)
+    {
+        std::size_t i = (std::size_t)zone * kNKillKinds + kind;
+        if (i >= fKillCounter.size()) fKillCounter.resize((std::size_t)(zone + 1) * kNKillKinds, 0);
+        fKillCounter[i]++;
+    }
+    // culled neutrals by kind
+    enum { kCullNeutron = 0, kCullGamma, kCullOther, kNCullKinds };
+    void CountCull(G4int kind)          { fCullCounter[kind]++; };
+    // importance biasing
+    void CountSplit(G4int copies)       { fNSplits++; fNCopies += copies; };
+    void CountRoulette(G4bool survived) { survived ? fNRouletteSurvived++ : fNRouletteKilled++; };
+    // stacking rules of this run, then kills by rule index
+    void SetStackRules(const std::vector<G4String>& names);
+    inline void CountStackKill(std::size_t rule)    { fStackKillCounter[rule]++; };
+
+    StepProfile* GetProfile()   { return &fProfile; };
+    VoxelMap* GetVoxelMap()     { return &fVoxelMap; };
+    EventCost* GetEventCost()   { return &fEventCost; };
+    WeightWindows::Tally* GetWindowTally()  { return &fWindowTally; };
+    PixelImage* GetPixelImage() { return &fPixelImage; };
+    ImageCube* GetImageCube()   { return &fImageCube; };
+    HitStream::Buffer* GetStreamBuffer()    { return &fStreamBuffer; };
+    // this thread's list-mode writer, nullptr when off
+    void SetListModeWriter(ListModeWriter* val) { fListMode = val; };
+    ListModeWriter* GetListModeWriter()     { return fListMode; };
 
     void Merge(const G4Run*) override;
     void EndOfRun(G4bool);
 
   private:
+    G4String ParticleName(G4int pdg) const;
+    G4String ChannelName(const ChannelKey&) const;
     void PrintXS(const G4VProcess*, const G4Material*, const G4Element*, G4HadronicProcessStore*,
                  G4double dens, G4double& sum1, G4double& sum2);
 
@@ -95,15 +175,35 @@ class Run : public G4Run
     G4ParticleDefinition* fParticle = nullptr;
     G4double fEkin = 0.;
 
-    std::map<G4String, G4int> fProcCounter;
+    // keyed by this thread's process objects; merged runs hold the entries
+    // of every worker and are summed by name in EndOfRun
+    FlatHashMap<const G4VProcess*, G4int> fProcCounter;
 
     G4int fTotalCount = 0;  // all processes counter
     G4int fGammaCount = 0;  // nb of events with gamma
+    G4long fNSpeciesOverflow = 0;  // channels truncated to kMaxSpecies
     G4double fSumTrack = 0.;  // sum of trackLength
     G4double fSumTrack2 = 0.;  // sum of trackLength*trackLength
 
-    std::map<G4String, NuclChannel> fNuclChannelMap;
-    std::map<G4String, ParticleData> fParticleDataMap;
+    FlatHashMap<ChannelKey, NuclChannel, ChannelHash> fNuclChannelMap;
+    FlatHashMap<G4int, ParticleData> fParticleDataMap;  // by PDG code
+    std::vector<G4long> fKillCounter;           // tracks stopped, per kill zone * kNKillKinds + kind
+    G4long fCullCounter[kNCullKinds] = {0};     // neutrals culled by direction
+    G4long fNSplits = 0;
+    G4long fNCopies = 0;
+    G4long fNRouletteSurvived = 0;
+    G4long fNRouletteKilled = 0;
+    std::vector<G4String> fStackRuleNames;
+    std::vector<G4long> fStackKillCounter;      // secondaries killed per stacking rule
+
+    StepProfile fProfile;
+    VoxelMap fVoxelMap;
+    EventCost fEventCost;
+    WeightWindows::Tally fWindowTally;
+    PixelImage fPixelImage;
+    ImageCube fImageCube;
+    HitStream::Buffer fStreamBuffer;
+    ListModeWriter* fListMode = nullptr;
 
     G4bool fTargetXXX = false;
     G4double fPbalance[3];
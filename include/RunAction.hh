@@ -35,7 +35,11 @@
 
 #include "G4UserRunAction.hh"
 #include "G4VProcess.hh"
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
 #include "globals.hh"
+#include "WeightWindows.hh"
+#include "HitStream.hh"
 
 #include <map>
 
@@ -47,6 +51,11 @@ class DetectorConstruction;
 class Run;
 class RunMessenger;
 class PrimaryGeneratorAction;
+class SteppingAction;
+class TrackingAction;
+class StackingAction;
+class EventCost;
+class ListModeWriter;
 class HistoManager;
 class G4Run;
 
@@ -66,6 +75,37 @@ class RunAction : public G4UserRunAction
     void EndOfRunAction(const G4Run*) override;
 
     void SetPrintFlag(G4bool);
+    void SetChannelAnalysis(G4bool val)             { fChannelAnalysis = val; };
+    void SetSteppingAction(SteppingAction* val)     { fStepping = val; };
+    void SetTrackingAction(TrackingAction* val)     { fTracking = val; };
+    void SetStackingAction(StackingAction* val)     { fStacking = val; };
+    void SetProfiling(G4bool val)                   { fProfiling = val; };
+    void SetProfileSampling(G4int val)              { fProfileSampling = val; };
+    void SetProfileFile(const G4String& val)        { fProfileFile = val; };
+    void SetVoxelMapping(G4bool val)                { fVoxelMapping = val; };
+    void SetVoxelGrid(G4int nx, G4int ny, G4int nz) { fVoxelN[0] = nx; fVoxelN[1] = ny; fVoxelN[2] = nz; };
+    void SetVoxelBox(G4ThreeVector lo, G4ThreeVector hi)    { fVoxelLo = lo; fVoxelHi = hi; };
+    void SetVoxelSplit(G4bool val)                  { fVoxelSplit = val; };
+    void SetVoxelFile(const G4String& val)          { fVoxelFile = val; };
+    void SetEventCost(G4bool val)                   { fEventCostOn = val; };
+    void SetNSlowEvents(G4int val)                  { fNSlowEvents = val; };
+    void SetSlowEventFile(const G4String& val)      { fSlowEventFile = val; };
+    void SetImageCube(G4bool val)                   { fImageCubeOn = val; };
+    void SetCubeBins(G4int nx, G4int ny, G4int nt)  { fCubeN[0] = nx; fCubeN[1] = ny; fCubeN[2] = nt; };
+    void SetCubeXY(G4double lo, G4double hi)        { fCubeXYLo = lo; fCubeXYHi = hi; };
+    void SetCubeTime(G4double lo, G4double hi)      { fCubeTLo = lo; fCubeTHi = hi; };
+    void SetCubeWeighted(G4bool val)                { fCubeWeighted = val; };
+    void SetFlightPath(G4double val)                { fFlightPath = val; };
+    void SetCubeFile(const G4String& val)           { fCubeFile = val; };
+    void SetNtupleMerging(G4bool);
+    void SetNtupleBackend(const G4String&);
+
+    // this run's per-event cost accounting, nullptr when off
+    EventCost* GetEventCost();
+    // this run's weight-window estimator, nullptr outside pilot runs
+    WeightWindows::Tally* GetWindowTally();
+    // this run's hit stream, nullptr when off
+    HitStream::Buffer* GetStreamBuffer();
     ProgressBar * GetProgBar() { return fProgBar; }
 
     //std::shared_ptr<THnSparseD> GetNeutronPhaseSpace() { return fhNeutronPhaseSpace; }
@@ -76,8 +116,35 @@ class RunAction : public G4UserRunAction
     Run* fRun = nullptr;
     HistoManager* fHistoManager = nullptr;
     RunMessenger* fRunMessenger = nullptr;
+    SteppingAction* fStepping = nullptr;    // this thread's, null on the master
+    TrackingAction* fTracking = nullptr;
+    StackingAction* fStacking = nullptr;
+    HitStream* fHitStream = nullptr;
+    ListModeWriter* fListMode = nullptr;
 
     G4bool fPrint = true;  // optional printing
+    G4bool fChannelAnalysis = false;
+    G4bool fProfiling = false;
+    G4int fProfileSampling = 100;
+    G4String fProfileFile = "profile.csv";
+    G4bool fVoxelMapping = false;
+    G4int fVoxelN[3] = {50, 50, 50};
+    G4ThreeVector fVoxelLo;     // lo == hi: whole world
+    G4ThreeVector fVoxelHi;
+    G4bool fVoxelSplit = false;
+    G4String fVoxelFile = "voxels.root";
+    G4bool fEventCostOn = false;
+    G4int fNSlowEvents = 10;
+    G4String fSlowEventFile = "slow_events.txt";
+    G4bool fImageCubeOn = false;
+    G4int fCubeN[3] = {100, 100, 700};
+    G4double fCubeXYLo = -50. * CLHEP::mm;
+    G4double fCubeXYHi = 50. * CLHEP::mm;
+    G4double fCubeTLo = 0.;
+    G4double fCubeTHi = 700. * CLHEP::ns;
+    G4bool fCubeWeighted = true;
+    G4double fFlightPath = 0.;  // 0: no energy axis
+    G4String fCubeFile = "image_cube.root";
     ProgressBar* fProgBar; 
     
     //std::shared_ptr<THnSparseD> fhNeutronPhaseSpace;
@@ -39,6 +39,10 @@
 class RunAction;
 class G4UIdirectory;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcommand;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -55,6 +59,29 @@ class RunMessenger : public G4UImessenger
 
     G4UIdirectory* fRunDir = nullptr;
     G4UIcmdWithABool* fPrintCmd = nullptr;
+
+    G4UIdirectory* fLDRSRunDir = nullptr;
+    G4UIcmdWithABool* fChannelAnalysisCmd = nullptr;
+    G4UIcmdWithABool* fProfilingCmd = nullptr;
+    G4UIcmdWithAnInteger* fProfileSamplingCmd = nullptr;
+    G4UIcmdWithAString* fProfileFileCmd = nullptr;
+    G4UIcmdWithABool* fVoxelMapCmd = nullptr;
+    G4UIcommand* fVoxelGridCmd = nullptr;
+    G4UIcommand* fVoxelBoxCmd = nullptr;
+    G4UIcmdWithABool* fVoxelSplitCmd = nullptr;
+    G4UIcmdWithAString* fVoxelFileCmd = nullptr;
+    G4UIcmdWithABool* fEventCostCmd = nullptr;
+    G4UIcmdWithAnInteger* fSlowEventsCmd = nullptr;
+    G4UIcmdWithAString* fSlowEventFileCmd = nullptr;
+    G4UIcmdWithABool* fImageCubeCmd = nullptr;
+    G4UIcommand* fCubeBinsCmd = nullptr;
+    G4UIcommand* fCubeXYCmd = nullptr;
+    G4UIcommand* fCubeTimeCmd = nullptr;
+    G4UIcmdWithABool* fCubeWeightedCmd = nullptr;
+    G4UIcmdWithADoubleAndUnit* fFlightPathCmd = nullptr;
+    G4UIcmdWithAString* fCubeFileCmd = nullptr;
+    G4UIcmdWithABool* fNtupleMergingCmd = nullptr;
+    G4UIcmdWithAString* fNtupleBackendCmd = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,71 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScintiFastModel.hh
+/// \brief Definition of the ScintiFastModel class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ScintiFastModel_h
+#define ScintiFastModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "G4EmCalculator.hh"
+#include "globals.hh"
+
+class G4Region;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Fast response of the scintillator panel to charged secondaries.
+///
+/// A recoil proton, ion or electron whose range fits inside the panel
+/// along its direction is absorbed where it starts: its kinetic energy is
+/// deposited in one synthetic step (so PanelSD still sees the time and
+/// position of the interaction) and the track is killed, skipping the
+/// detailed EM cascade. The ranges come from the restricted dE/dx tables
+/// that the EM physics already builds, and are longer than the true path,
+/// so a track is only absorbed when it is certainly contained; the others
+/// are tracked in detail.
+
+class ScintiFastModel : public G4VFastSimulationModel
+{
+  public:
+    ScintiFastModel(const G4String& name, G4Region* envelope);
+    ~ScintiFastModel() override = default;
+
+    G4bool IsApplicable(const G4ParticleDefinition&) override;
+    G4bool ModelTrigger(const G4FastTrack&) override;
+    void DoIt(const G4FastTrack&, G4FastStep&) override;
+
+  private:
+    G4EmCalculator fCalculator;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,105 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScorerRegistry.hh
+/// \brief Definition of the ScorerRegistry class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef ScorerRegistry_h
+#define ScorerRegistry_h 1
+
+#include "G4VPhysicalVolume.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class ScorerMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Boundary-crossing scorers.
+///
+/// Each scorer is a (from-volume, to-volume, ntuple) triple. Volumes are
+/// given by physical or logical volume name ("World" for the world volume),
+/// so every placed copy of an assembly matches. Resolve() turns the list into
+/// a dense table over the matched volumes, so that a step costs the same
+/// constant number of array loads whatever the number of scorers.
+
+class ScorerRegistry
+{
+  public:
+    struct Scorer
+    {
+        G4String fFrom;
+        G4String fTo;
+        G4int    fNtuple;   // HistoManager ntuple id
+    };
+
+  public:
+    ScorerRegistry();
+    ~ScorerRegistry();
+
+    void AddScorer(const G4String& from, const G4String& to, const G4String& ntuple);
+    void Clear();
+    void List() const;
+
+    // build the dense lookup table from the current G4PhysicalVolumeStore
+    void Resolve();
+
+    const Scorer& GetScorer(G4int i) const  { return fScorers[i]; };
+    G4bool IsEmpty() const                  { return fScorers.empty(); };
+
+    // scorer index for a step from pre to post (post == nullptr when leaving
+    // the world), -1 if none
+    inline G4int Lookup(const G4VPhysicalVolume* pre, const G4VPhysicalVolume* post) const
+    {
+        std::size_t from = pre->GetInstanceID();
+        std::size_t to = post ? post->GetInstanceID() : fOutsideID;
+        if (from >= fDense.size() || to >= fDense.size()) return -1;
+        return fTable[fDense[from] * fNDense + fDense[to]];
+    }
+
+  private:
+    G4bool Matches(const G4String& pattern, const G4VPhysicalVolume* pv) const;
+
+  private:
+    ScorerMessenger* fMessenger = nullptr;
+
+    std::vector<Scorer> fScorers;
+
+    // instance ID -> dense index (0 = volume not used by any scorer)
+    std::vector<G4int> fDense;
+    std::size_t fOutsideID = 0;
+    G4int fNDense = 1;
+    // fNDense x fNDense, scorer index or -1
+    std::vector<G4int> fTable;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,91 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class StackingMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Rule-based classification of new secondaries.
+///
+/// A secondary is killed before it is ever tracked if it matches any rule:
+/// a particle type, a kinetic energy below a per-particle threshold, a
+/// global time past the time-of-flight window, or a birth volume / region.
+/// Primaries are always tracked. Kills are counted per rule in the Run.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    enum { kParticle = 0, kEnergy, kTime, kBirth };
+
+    struct Rule
+    {
+        G4int       fType;
+        G4int       fPDG = 0;
+        G4double    fValue = 0.;
+        G4String    fVolume;
+        G4String    fName;      // as printed in the run summary
+    };
+
+  public:
+    StackingAction();
+    ~StackingAction() override;
+
+    G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*) override;
+
+    void AddParticleRule(const G4String& particle);
+    void AddEnergyRule(const G4String& particle, G4double ekin);
+    void AddTimeRule(G4double time);
+    void AddBirthRule(const G4String& volume);
+    void Clear()    { fRules.clear(); };
+    void List() const;
+    std::vector<G4String> GetRuleNames() const;
+
+  private:
+    G4int FindPDG(const G4String& particle) const;
+    G4bool Matches(const Rule&, const G4Track*) const;
+
+  private:
+    StackingMessenger* fMessenger = nullptr;
+    std::vector<Rule> fRules;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
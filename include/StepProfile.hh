@@ -0,0 +1,123 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepProfile.hh
+/// \brief Definition of the StepProfile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepProfile_h
+#define StepProfile_h 1
+
+#include "FlatHashMap.hh"
+#include "StepTimer.hh"
+
+#include "G4Step.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "globals.hh"
+
+class G4ParticleDefinition;
+class G4VProcess;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Step, track and wall-time accounting per (logical volume, particle,
+/// process that limited the step).
+///
+/// Every step is counted; wall time is sampled with a StepTimer. Keys are
+/// object pointers, so the tables of several threads are summed by name
+/// only when the report is written.
+
+class StepProfile
+{
+  public:
+    struct Key
+    {
+        const G4LogicalVolume*      fVolume = nullptr;
+        const G4ParticleDefinition* fParticle = nullptr;
+        const G4VProcess*           fProcess = nullptr;
+
+        G4bool operator==(const Key& other) const
+        {
+            return fVolume == other.fVolume && fParticle == other.fParticle
+                && fProcess == other.fProcess;
+        }
+    };
+
+    struct KeyHash
+    {
+        std::uint64_t operator()(const Key& key) const
+        {
+            return ((std::uintptr_t)key.fVolume * 31 + (std::uintptr_t)key.fParticle) * 31
+                + (std::uintptr_t)key.fProcess;
+        }
+    };
+
+    struct Data
+    {
+        G4long      fSteps = 0;
+        G4long      fTracks = 0;
+        G4double    fTime = 0.;     // estimated seconds
+    };
+
+  public:
+    StepProfile() = default;
+    ~StepProfile() = default;
+
+    void SetSampling(G4int val)     { fTimer.SetSampling(val); };
+
+    inline void Fill(const G4Step* aStep)
+    {
+        Key key;
+        // no volume ("none" in the report) if the pre-step point has none
+        const G4VPhysicalVolume* volume = aStep->GetPreStepPoint()->GetPhysicalVolume();
+        key.fVolume = volume ? volume->GetLogicalVolume() : nullptr;
+        key.fParticle = aStep->GetTrack()->GetDefinition();
+        key.fProcess = aStep->GetPostStepPoint()->GetProcessDefinedStep();
+
+        Data& data = fTable[key];
+        data.fSteps++;
+        if (aStep->GetTrack()->GetCurrentStepNumber() == 1) data.fTracks++;
+        data.fTime += fTimer.Sample();
+    }
+
+    void Merge(const StepProfile&);
+    void Clear()    { fTable.Clear(); };
+    G4bool Empty() const    { return fTable.Empty(); };
+
+    // sorted summary on G4cout and one CSV line per entry
+    void Report(const G4String& fileName) const;
+
+  private:
+    FlatHashMap<Key, Data, KeyHash> fTable;
+    StepTimer fTimer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
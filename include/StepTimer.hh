@@ -0,0 +1,76 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepTimer.hh
+/// \brief Definition of the StepTimer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef StepTimer_h
+#define StepTimer_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Sampled per-step wall time.
+///
+/// Called once per step from the stepping action. After every fSampling
+/// steps the clock is read at the end of one step and again at the end of
+/// the next; that interval, scaled by the sampling period, is returned for
+/// the second step. All other steps return 0 without reading the clock.
+
+class StepTimer
+{
+  public:
+    void SetSampling(G4int val)     { fSampling = val; fCounter = 0; };
+
+    // estimated seconds to charge to the step just finished
+    inline G4double Sample()
+    {
+        if (++fCounter == fSampling) {
+            fStart = std::chrono::steady_clock::now();
+        }
+        else if (fCounter > fSampling) {
+            std::chrono::duration<G4double> dt = std::chrono::steady_clock::now() - fStart;
+            fCounter = 0;
+            return dt.count() * (fSampling + 1);
+        }
+        return 0.;
+    }
+
+  private:
+    G4int fSampling = 100;
+    G4int fCounter = 0;
+    std::chrono::steady_clock::time_point fStart;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -35,26 +35,107 @@
 
 #include "G4UserSteppingAction.hh"
 #include "globals.hh"
+#include "WeightWindows.hh"
+#include "ImageEstimator.hh"
 
-#include <map>
+#include <array>
+#include <utility>
+#include <vector>
 
-class G4ParticleDefinition;
 class DetectorConstruction;
+class StepProfile;
+class VoxelMap;
+class ScorerRegistry;
+class KillZones;
+class ImportanceBiasing;
+class PixelImage;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+/// The per-step work is a pipeline of optional stages. The combinations
+/// runs commonly use are compiled as their own Step<Stages>() instantiation,
+/// so a step only runs (inlined) the stages the run uses; any other
+/// combination goes through Step<kGeneric>, which tests each stage at run
+/// time. SelectPipeline() picks one from the configuration at the start of
+/// a run.
+
 class SteppingAction : public G4UserSteppingAction
 {
   public:
-    SteppingAction() = default;
+    // pipeline stages
+    enum {
+        kScore      = 1 << 0,   // boundary-crossing scorers
+        kAnalysis   = 1 << 1,   // first-interaction channel analysis
+        kCull       = 1 << 2,   // directional culling of neutrals
+        kKill       = 1 << 3,   // kill zones
+        kProfile    = 1 << 4,   // per volume / particle / process profiler
+        kVoxel      = 1 << 5,   // step and time density maps
+        kBias       = 1 << 6,   // importance splitting and roulette
+        kWindow     = 1 << 7,   // weight windows: pilot estimator and/or applied
+        kEstimate   = 1 << 8,   // next-event and track-length panel images
+        kGeneric    = 1 << 9    // not a stage: the stages are read from fStages
+    };
+
+  public:
     SteppingAction(DetectorConstruction*);
     ~SteppingAction() override = default;
 
-    void UserSteppingAction(const G4Step*) override;
+    void UserSteppingAction(const G4Step* aStep) override  { (this->*fPipeline)(aStep); };
+
+    // Hadr03-style accounting of the first interaction of each primary
+    void SetChannelAnalysis(G4bool val)     { fChannelAnalysis = val; };
+    // profile table to fill, nullptr to run without profiling
+    void SetProfile(StepProfile* val)       { fProfile = val; };
+    void SetVoxelMap(VoxelMap* val)         { fVoxelMap = val; };
+    void SetWindowTally(WeightWindows::Tally* val)  { fWindowTally = val; };
+    // image the estimators score into, nullptr when they are off
+    void SetEstimatorImage(PixelImage* val)     { fEstimatorImage = val; };
+
+    // choose the pipeline for the current scorer / kill zone configuration
+    void SelectPipeline();
 
   private:
-    std::map<G4ParticleDefinition*, G4int> fParticleFlag;
+    using Pipeline = void (SteppingAction::*)(const G4Step*);
+    static Pipeline GetPipeline(unsigned stages);
+    template <std::size_t... Index>
+    static std::array<Pipeline, sizeof...(Index)> MakePipelines(std::index_sequence<Index...>);
+
+    template <unsigned Stages>
+    void Step(const G4Step*);
+    template <unsigned Stages>
+    inline G4bool Has(unsigned stage) const
+    {
+        if constexpr ((Stages & kGeneric) != 0) return (fStages & stage) != 0;
+        else return (Stages & stage) != 0;
+    }
+
+    void Score(const G4Step*, G4int scorer);
+    void AnalyseInteraction(const G4Step*);
+    void Cull(const G4Step*);
+    void Kill(const G4Step*);
+    void Bias(const G4Step*);
+    void Window(const G4Step*);
+    void Estimate(const G4Step*);
+    // the track and n-1 copies of it, all with the given weight
+    void Split(G4Track*, G4int n, G4double weight);
+
+  private:
+    Pipeline fPipeline = nullptr;
+    unsigned fStages = 0;
+
+    G4bool fChannelAnalysis = false;
+    std::vector<G4int> fProducts;   // PDG codes of the current interaction
     DetectorConstruction* fDetector = nullptr; 
+    ScorerRegistry* fScorers = nullptr;
+    KillZones* fKillZones = nullptr;
+    ImportanceBiasing* fBiasing = nullptr;
+    WeightWindows* fWeightWindows = nullptr;
+    WeightWindows::Tally* fWindowTally = nullptr;
+    StepProfile* fProfile = nullptr;
+    VoxelMap* fVoxelMap = nullptr;
+    ImageEstimator* fEstimator = nullptr;
+    ImageEstimator::Tracer fTracer;
+    PixelImage* fEstimatorImage = nullptr;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
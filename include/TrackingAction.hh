@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file TrackingAction.hh
+/// \brief Definition of the TrackingAction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef TrackingAction_h
+#define TrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class EventCost;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class TrackingAction : public G4UserTrackingAction
+{
+  public:
+    TrackingAction() = default;
+    ~TrackingAction() override = default;
+
+    void PreUserTrackingAction(const G4Track*) override;
+    void PostUserTrackingAction(const G4Track*) override;
+
+    // per-event cost accounting, nullptr when off
+    void SetEventCost(EventCost* val)   { fEventCost = val; };
+
+    // split branch of a track started in this event: 0 for the primaries and
+    // their secondaries, else the ID of the split copy it descends from
+    G4int GetBranch(G4int trackID) const
+    {
+        return trackID < (G4int)fBranch.size() ? fBranch[trackID] : 0;
+    };
+
+  private:
+    EventCost* fEventCost = nullptr;
+    // by track ID; entries are overwritten as tracks start, and a parent
+    // always starts before its secondaries, so nothing is reset per event
+    std::vector<G4int> fBranch;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
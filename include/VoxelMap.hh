@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file VoxelMap.hh
+/// \brief Definition of the VoxelMap class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef VoxelMap_h
+#define VoxelMap_h 1
+
+#include "StepTimer.hh"
+
+#include "G4Step.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// 3-D map of steps taken and (sampled) wall time spent, over a box
+/// divided into nx x ny x nz voxels, optionally split by particle type.
+///
+/// Each thread fills the dense arrays of its own Run from the stepping
+/// action; Run::Merge adds them, and the master writes one TH3D per
+/// quantity and particle category at end of run.
+
+class VoxelMap
+{
+  public:
+    enum { kNeutron = 0, kGamma, kElectron, kProton, kOther, kNCategories };
+
+  public:
+    VoxelMap() = default;
+    ~VoxelMap() = default;
+
+    void Configure(G4int nx, G4int ny, G4int nz, const G4ThreeVector& lo, const G4ThreeVector& hi,
+                   G4bool split, G4int sampling);
+
+    inline void Fill(const G4Step* aStep)
+    {
+        G4double dt = fTimer.Sample();
+        const G4ThreeVector& pos = aStep->GetPostStepPoint()->GetPosition();
+        G4int ix = (G4int)((pos.x() - fLo.x()) * fInvWidth.x());
+        G4int iy = (G4int)((pos.y() - fLo.y()) * fInvWidth.y());
+        G4int iz = (G4int)((pos.z() - fLo.z()) * fInvWidth.z());
+        if (pos.x() < fLo.x() || ix >= fN[0] || pos.y() < fLo.y() || iy >= fN[1]
+                || pos.z() < fLo.z() || iz >= fN[2]) return;
+
+        std::size_t voxel = ((std::size_t)iz * fN[1] + iy) * fN[0] + ix;
+        if (fSplit) voxel += Category(aStep->GetTrack()->GetDefinition()->GetPDGEncoding()) * fNVoxels;
+        fSteps[voxel] += 1.;
+        fTime[voxel] += dt;
+    }
+
+    void Merge(const VoxelMap&);
+    G4bool IsConfigured() const     { return !fSteps.empty(); };
+
+    // one TH3D per quantity (and category) into a new ROOT file
+    void Write(const G4String& fileName) const;
+
+  private:
+    static G4int Category(G4int pdg)
+    {
+        switch (pdg) {
+            case 2112:          return kNeutron;
+            case 22:            return kGamma;
+            case 11: case -11:  return kElectron;
+            case 2212:          return kProton;
+            default:            return kOther;
+        }
+    }
+
+  private:
+    G4int fN[3] = {0, 0, 0};
+    std::size_t fNVoxels = 0;
+    G4ThreeVector fLo;
+    G4ThreeVector fHi;
+    G4ThreeVector fInvWidth;
+    G4bool fSplit = false;
+
+    std::vector<G4double> fSteps;   // [category][iz][iy][ix]
+    std::vector<G4double> fTime;    // estimated seconds
+    StepTimer fTimer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,160 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file WeightWindows.hh
+/// \brief Definition of the WeightWindows class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef WeightWindows_h
+#define WeightWindows_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+class DetectorConstruction;
+class WeightWindowMessenger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Space-energy weight windows generated from pilot runs.
+///
+/// The mesh is a world-frame box of nx x ny x nz cells times log-spaced
+/// energy groups. During a pilot run every track entering a cell (or born
+/// in it) adds its weight to the cell, and at end of event the panel
+/// score of the event is credited to every cell entered in it. The ratio
+/// score / weight is a forward estimate of the cell's importance for the
+/// PanelSD tally; at end of run the master turns it into windows whose
+/// survival weight is I_source / I_cell and writes them to a file.
+///
+/// Each pilot iteration can run with the previous windows applied, which
+/// pushes more histories into the cells the first guess starved.
+
+class WeightWindows
+{
+  public:
+    /// per-run estimator, one per thread's Run, merged by Run::Merge
+    class Tally
+    {
+      public:
+        void Configure(std::size_t nCells, G4bool active);
+        G4bool IsActive() const             { return fActive; };
+
+        inline void Enter(G4int cell, G4double weight)
+        {
+            if (fEventWeight[cell] == 0.) fEntered.push_back(cell);
+            fEventWeight[cell] += weight;
+        }
+        inline void Score(G4double weight)  { fEventScore += weight; };
+        void EndEvent();
+        void Merge(const Tally&);
+
+      private:
+        friend class WeightWindows;
+        G4bool fActive = false;
+        std::vector<G4double> fWeight;      // weight entering each cell
+        std::vector<G4double> fCredit;      // panel score of those histories
+        G4double fTotalScore = 0.;
+        // this event: weight entering each cell, and the cells entered
+        std::vector<G4double> fEventWeight;
+        std::vector<G4int> fEntered;
+        G4double fEventScore = 0.;
+    };
+
+  public:
+    WeightWindows(DetectorConstruction*);
+    ~WeightWindows();
+
+    // a new mesh drops the current windows
+    void SetMesh(G4int nx, G4int ny, G4int nz);
+    void SetBox(const G4ThreeVector& lo, const G4ThreeVector& hi);
+    void SetEnergyGroups(G4int n, G4double emin, G4double emax);
+    void SetRatio(G4double val)     { fRatio = val; };
+    void SetPilot(G4bool val)       { fPilot = val; };
+    void SetApply(G4bool val)       { fApply = val; };
+    void SetFile(const G4String& val)   { fFile = val; };
+
+    G4bool IsPilot() const          { return fPilot; };
+    G4bool IsApplied() const        { return fApply; };
+    std::size_t GetNCells() const   { return fLower.size(); };
+
+    // master, begin of run: mesh over the world unless a box was given
+    void Resolve();
+    // master, end of a pilot run: new windows from the merged tally
+    void Update(const Tally&, G4int nPrimaries);
+    void Save(const G4String& fileName) const;
+    G4bool Load(const G4String& fileName);
+
+    // cell index, -1 outside the mesh
+    inline G4int Cell(const G4ThreeVector& pos, G4double energy) const
+    {
+        G4int ix = (G4int)((pos.x() - fLo.x()) * fInvWidth.x());
+        G4int iy = (G4int)((pos.y() - fLo.y()) * fInvWidth.y());
+        G4int iz = (G4int)((pos.z() - fLo.z()) * fInvWidth.z());
+        if (pos.x() < fLo.x() || ix >= fN[0] || pos.y() < fLo.y() || iy >= fN[1]
+                || pos.z() < fLo.z() || iz >= fN[2]) return -1;
+        G4int ie = 0;
+        if (fNGroups > 1 && energy > fEmin) {
+            ie = std::min((G4int)(std::log(energy / fEmin) * fInvLogWidth), fNGroups - 1);
+        }
+        return ((ie * fN[2] + iz) * fN[1] + iy) * fN[0] + ix;
+    }
+
+    // lower bound of the window, 0 where the pilot saw no score
+    G4double GetLower(G4int cell) const     { return fLower[cell]; };
+    G4double GetRatio() const               { return fRatio; };
+
+  private:
+    DetectorConstruction* fDetector = nullptr;
+    WeightWindowMessenger* fMessenger = nullptr;
+
+    G4int fN[3] = {20, 20, 20};
+    G4ThreeVector fLo;
+    G4ThreeVector fHi;
+    G4ThreeVector fInvWidth;
+    G4int fNGroups = 1;
+    G4double fEmin = 0.;
+    G4double fEmax = 0.;
+    G4double fInvLogWidth = 0.;
+    G4double fRatio = 5.;           // upper / lower bound
+
+    G4bool fPilot = false;
+    G4bool fApply = false;
+    G4bool fLoaded = false;
+    G4String fFile = "weight_windows.txt";
+
+    std::vector<G4double> fLower;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -33,6 +33,8 @@
 #include "RunAction.hh"
 #include "SteppingAction.hh"
 #include "EventAction.hh"
+#include "StackingAction.hh"
+#include "TrackingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -59,9 +61,18 @@ void ActionInitialization::Build() const
 
   SteppingAction* steppingAction = new SteppingAction(fDetector);
   SetUserAction(steppingAction);
+  runAction->SetSteppingAction(steppingAction);
 
   EventAction* eventAction = new EventAction(runAction);
   SetUserAction(eventAction);
+
+  StackingAction* stackingAction = new StackingAction();
+  SetUserAction(stackingAction);
+  runAction->SetStackingAction(stackingAction);
+
+  TrackingAction* trackingAction = new TrackingAction();
+  SetUserAction(trackingAction);
+  runAction->SetTrackingAction(trackingAction);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
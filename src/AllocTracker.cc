@@ -0,0 +1,197 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file AllocTracker.cc
+/// \brief Implementation of the AllocTracker class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "AllocTracker.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace
+{
+    // one cache line per thread; threads beyond kMaxSlots are not counted
+    constexpr G4int kMaxSlots = 256;
+
+    struct alignas(64) Slot
+    {
+        AllocTracker::Counts fCounts;
+    };
+
+    Slot gSlots[kMaxSlots];
+    std::atomic<G4int> gNSlots{0};
+
+#ifdef LDRS_ALLOC_TRACKING
+    G4ThreadLocal G4int tSlot = -1;
+
+    AllocTracker::Counts* LocalCounts()
+    {
+        if (tSlot < 0) tSlot = gNSlots.fetch_add(1, std::memory_order_relaxed);
+        return tSlot < kMaxSlots ? &gSlots[tSlot].fCounts : nullptr;
+    }
+#endif
+
+    const char* const kPhaseNames[AllocTracker::kNPhases] =
+        { "initialization", "BeginOfEvent", "stepping", "EndOfEvent", "end-of-run merge" };
+}
+
+AllocTracker::Counts AllocTracker::fRunStart;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef LDRS_ALLOC_TRACKING
+
+G4ThreadLocal AllocTracker::Phase AllocTracker::fPhase = AllocTracker::kInit;
+
+void AllocTracker::CountAlloc(std::size_t bytes)
+{
+    if (Counts* counts = LocalCounts()) {
+        counts->fAllocs[fPhase]++;
+        counts->fBytes[fPhase] += bytes;
+    }
+}
+
+void AllocTracker::CountFree()
+{
+    if (Counts* counts = LocalCounts()) counts->fFrees[fPhase]++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// global replacements; everything else (nothrow, sized, array) forwards here
+
+void* operator new(std::size_t size)
+{
+    AllocTracker::CountAlloc(size);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    AllocTracker::CountAlloc(size);
+    std::size_t a = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)                                  { return operator new(size); }
+void* operator new[](std::size_t size, std::align_val_t align)          { return operator new(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    AllocTracker::CountAlloc(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void* p) noexcept
+{
+    if (!p) return;
+    AllocTracker::CountFree();
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept                { operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept                     { operator delete(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept   { operator delete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept           { operator delete(p); }
+void operator delete[](void* p) noexcept                                { operator delete(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept                   { operator delete(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { operator delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept         { operator delete(p); }
+
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AllocTracker::Counts AllocTracker::Total()
+{
+    Counts total;
+    G4int n = std::min(gNSlots.load(std::memory_order_relaxed), kMaxSlots);
+    for (G4int i = 0; i < n; i++) {
+        for (G4int ph = 0; ph < kNPhases; ph++) {
+            total.fAllocs[ph] += gSlots[i].fCounts.fAllocs[ph];
+            total.fBytes[ph] += gSlots[i].fCounts.fBytes[ph];
+            total.fFrees[ph] += gSlots[i].fCounts.fFrees[ph];
+        }
+    }
+    return total;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AllocTracker::BeginRun()
+{
+    if (IsEnabled()) fRunStart = Total();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AllocTracker::Report(G4int nEvents)
+{
+    if (!IsEnabled()) return;
+
+    Counts now = Total();
+    G4double norm = nEvents > 0 ? 1. / nEvents : 0.;
+
+    G4cout << "\n --------------- Heap allocations per event (all threads) --------------- "
+           << "\n " << std::setw(18) << "phase" << std::setw(14) << "allocs/evt"
+           << std::setw(14) << "bytes/evt" << std::setw(14) << "frees/evt"
+           << std::setw(16) << "allocs (run)" << G4endl;
+    std::streamsize prec = G4cout.precision(4);
+    for (G4int ph = 0; ph < kNPhases; ph++) {
+        uint64_t allocs = now.fAllocs[ph] - fRunStart.fAllocs[ph];
+        uint64_t bytes = now.fBytes[ph] - fRunStart.fBytes[ph];
+        uint64_t frees = now.fFrees[ph] - fRunStart.fFrees[ph];
+        G4cout << " " << std::setw(18) << kPhaseNames[ph]
+               << std::setw(14) << allocs * norm
+               << std::setw(14) << bytes * norm
+               << std::setw(14) << frees * norm
+               << std::setw(16) << allocs << G4endl;
+    }
+    G4cout.precision(prec);
+    G4cout << " (EndOfEvent includes generating the next primary; allocations outside events"
+           << "\n  before this run: " << fRunStart.fAllocs[kInit] << " allocs, "
+           << fRunStart.fBytes[kInit] << " bytes)" << G4endl;
+    if (gNSlots.load() > kMaxSlots) {
+        G4cout << " ---> more than " << kMaxSlots << " threads, the extra ones are not counted" << G4endl;
+    }
+    G4cout << " ------------------------------------------------------------------------ " << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
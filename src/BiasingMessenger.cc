@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file BiasingMessenger.cc
+/// \brief Implementation of the BiasingMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "BiasingMessenger.hh"
+
+#include "ImportanceBiasing.hh"
+
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BiasingMessenger::BiasingMessenger(ImportanceBiasing* biasing) : fBiasing(biasing)
+{
+    fDir = new G4UIdirectory("/LDRS/bias/");
+    fDir->SetGuidance("geometry-importance splitting and Russian roulette");
+
+    fSetLayerCmd = new G4UIcommand("/LDRS/bias/setLayer", this);
+    fSetLayerCmd->SetGuidance("split a logical volume into cells by depth, with importances");
+    fSetLayerCmd->SetGuidance("growing geometrically from the outer to the inner cell");
+    fSetLayerCmd->SetGuidance("ignored while weight windows are applied or piloted");
+    fSetLayerCmd->SetGuidance("[usage] /LDRS/bias/setLayer volume nCells outer inner");
+    auto namePrm = new G4UIparameter("volume", 's', false);
+    fSetLayerCmd->SetParameter(namePrm);
+    auto cellsPrm = new G4UIparameter("nCells", 'i', false);
+    cellsPrm->SetParameterRange("nCells>=1");
+    fSetLayerCmd->SetParameter(cellsPrm);
+    auto outerPrm = new G4UIparameter("outer", 'd', false);
+    outerPrm->SetParameterRange("outer>0.");
+    fSetLayerCmd->SetParameter(outerPrm);
+    auto innerPrm = new G4UIparameter("inner", 'd', false);
+    innerPrm->SetParameterRange("inner>0.");
+    fSetLayerCmd->SetParameter(innerPrm);
+    fSetLayerCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fMaxSplitCmd = new G4UIcmdWithAnInteger("/LDRS/bias/maxSplit", this);
+    fMaxSplitCmd->SetGuidance("largest number of copies a track is split into at once");
+    fMaxSplitCmd->SetParameterName("n", false);
+    fMaxSplitCmd->SetRange("n>=2");
+    fMaxSplitCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fClearCmd = new G4UIcmdWithoutParameter("/LDRS/bias/clear", this);
+    fClearCmd->SetGuidance("remove all importance layers");
+    fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fListCmd = new G4UIcmdWithoutParameter("/LDRS/bias/list", this);
+    fListCmd->SetGuidance("list the importance layers");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BiasingMessenger::~BiasingMessenger()
+{
+    delete fSetLayerCmd;
+    delete fMaxSplitCmd;
+    delete fClearCmd;
+    delete fListCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BiasingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fSetLayerCmd) {
+        G4String name;
+        G4int nCells;
+        G4double outer, inner;
+        std::istringstream is(newValue);
+        is >> name >> nCells >> outer >> inner;
+        fBiasing->SetLayer(name, nCells, outer, inner);
+    }
+
+    if (command == fMaxSplitCmd) {
+        fBiasing->SetMaxSplit(fMaxSplitCmd->GetNewIntValue(newValue));
+    }
+
+    if (command == fClearCmd) {
+        fBiasing->Clear();
+    }
+
+    if (command == fListCmd) {
+        fBiasing->List();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
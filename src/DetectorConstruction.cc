@@ -35,6 +35,13 @@
 
 #include "DetectorMessenger.hh"
 #include "PanelSD.hh"
+#include "ScintiFastModel.hh"
+#include "ScorerRegistry.hh"
+#include "KillZones.hh"
+#include "ImportanceBiasing.hh"
+#include "WeightWindows.hh"
+#include "Digitizer.hh"
+#include "ImageEstimator.hh"
 
 #include "GeometryCollimator.hh"   
 #include "GeometryCatcher.hh"   
@@ -52,6 +59,8 @@
 #include "G4NistManager.hh"
 #include "G4PVPlacement.hh"
 #include "G4PhysicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4RunManager.hh"
 #include "G4SolidStore.hh"
 #include "G4SystemOfUnits.hh"
@@ -61,6 +70,9 @@
 #include "G4Colour.hh"
 #include "G4SDManager.hh"
 
+#include <algorithm>
+#include <cmath>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
@@ -69,6 +81,7 @@ DetectorConstruction::DetectorConstruction()
     fRotation = G4ThreeVector(0., 0., 0.);
 
     fWorldXYZ = 10 * m;
+    fWorldMaterialName = "G4_AIR";
 
     // default catcher params
     fCatcherRadius = 2.5 * cm;
@@ -98,6 +111,12 @@ DetectorConstruction::DetectorConstruction()
 
     DefineMaterials();
     fDetectorMessenger = new DetectorMessenger(this);
+    fScorers = new ScorerRegistry();
+    fKillZones = new KillZones(this);
+    fBiasing = new ImportanceBiasing();
+    fWeightWindows = new WeightWindows(this);
+    fDigitizer = new Digitizer();
+    fImageEstimator = new ImageEstimator(this);
 
 }
 
@@ -106,6 +125,13 @@ DetectorConstruction::DetectorConstruction()
 DetectorConstruction::~DetectorConstruction()
 {
     delete fDetectorMessenger;
+    delete fScorers;
+    delete fKillZones;
+    delete fBiasing;
+    delete fWeightWindows;
+    delete fDigitizer;
+    delete fImageEstimator;
+    delete fPanel;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -138,7 +164,7 @@ G4VPhysicalVolume* DetectorConstruction::ConstructVolumes()
     // world volume
     G4Box* sWorld = new G4Box("sWorld", 
             fWorldXYZ/2., fWorldXYZ/2., fWorldXYZ/2.);
-    material = man->FindOrBuildMaterial("G4_AIR");
+    material = man->FindOrBuildMaterial(fWorldMaterialName);
     fLWorld = new G4LogicalVolume(sWorld, 
             material,
             material->GetName());
@@ -152,17 +178,26 @@ G4VPhysicalVolume* DetectorConstruction::ConstructVolumes()
             0);                     // copy number
 
 
-    // detector panel
-    GeometryDetectorPanel* panel = new GeometryDetectorPanel();
-    panel->SetXY(fDetectorPanelXY);
-    panel->SetZ(fDetectorPanelZ);
-    panel->Build();
-    G4RotationMatrix* rotate = new G4RotationMatrix();
-    rotate->rotateX(fRotation.x()*M_PI/180.);
-    rotate->rotateY(fRotation.y()*M_PI/180.);
-    rotate->rotateZ(fRotation.z()*M_PI/180.);    
-    panel->PlaceDetector(fLWorld, fPosition, rotate);
-    fLDetectorPanel = panel->GetScintiLog();
+    // placed components are recorded from scratch for each new world
+    fExtents.clear();
+    fSampleLogs.clear();
+
+    // detector panel; more copies are placed with /LDRS/det/placePanel
+    delete fPanel;
+    fPanel = new GeometryDetectorPanel();
+    fPanel->SetXY(fDetectorPanelXY);
+    fPanel->SetZ(fDetectorPanelZ);
+    fPanel->SetPixels(GetPanelPixels());
+    fPanel->Build();
+    fLDetectorPanel = fPanel->GetSensitiveLog();
+    fNPanels = 0;
+    PlaceDetectorPanel();
+
+    // envelope of the fast scintillator response; the pixels inherit it
+    if (fPanelFastSim) {
+        G4Region* region = G4RegionStore::GetInstance()->FindOrCreateRegion("PanelRegion");
+        region->AddRootLogicalVolume(fPanel->GetScintiLog());
+    }
 
     //PrintParameters();
     //G4cout << *(G4Material::GetMaterialTable()) << G4endl;
@@ -178,8 +213,47 @@ void DetectorConstruction::ConstructSDandField()
     // Sensitive detectors
     G4String panelSDname = "PanelSD";
     auto panelSD = new PanelSD(panelSDname, "PanelHitsCollection");
+    panelSD->SetPixels(GetPanelPixels());
+    panelSD->SetHitRows(fPanelHitRows);
+    panelSD->SetDigitizer(fDigitizer);
     G4SDManager::GetSDMpointer()->AddNewDetector(panelSD);
     SetSensitiveDetector(fLDetectorPanel, panelSD);
+
+    // fast simulation models are thread-local, like the detectors
+    if (fPanelFastSim) {
+        new ScintiFastModel("ScintiFastModel", G4RegionStore::GetInstance()->GetRegion("PanelRegion"));
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int DetectorConstruction::GetPanelPixels() const
+{
+    // the pitch is rounded so that pixels tile the panel exactly
+    if (fPanelPitch <= 0.) return 0;
+    return std::max(1, (G4int)std::lround(fDetectorPanelXY / fPanelPitch));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::PlaceDetectorPanel() 
+{
+    G4cout << " ---> Placing detector panel " << fNPanels << "... " << G4endl;
+
+    // every copy shares the logical volumes, hence the sensitive detector
+    G4RotationMatrix* rotate = new G4RotationMatrix();
+    rotate->rotateX(fRotation.x()*M_PI/180.);
+    rotate->rotateY(fRotation.y()*M_PI/180.);
+    rotate->rotateZ(fRotation.z()*M_PI/180.);    
+
+    fPanel->PlaceDetector(fLWorld, fPosition, rotate);
+    fNPanels++;
+
+    Extent& ext = AddExtent("DetectorPanel",
+            G4ThreeVector(-fDetectorPanelXY/2., -fDetectorPanelXY/2., 0.),
+            G4ThreeVector( fDetectorPanelXY/2.,  fDetectorPanelXY/2., fDetectorPanelZ),
+            rotate);
+    ext.fCopyNo = fPanel->GetScintiCopyNo();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -201,6 +275,11 @@ void DetectorConstruction::PlaceCatcher()
     
     catcher->PlaceDetector(fLWorld, fPosition, rotate);
 
+    AddExtent("Catcher",
+            G4ThreeVector(-fCatcherRadius, -fCatcherRadius, 0.),
+            G4ThreeVector( fCatcherRadius,  fCatcherRadius, fCatcherZ),
+            rotate);
+
     // after catcher placed, we can set the PV
     G4cout << " ---> Trying to assign catcher physical volume: " << catcher->GetCatcherPhys() << G4endl;
     fPCatcher = catcher->GetCatcherPhys();
@@ -225,6 +304,11 @@ void DetectorConstruction::PlaceCollimator()
     rotate->rotateZ(fRotation.z()*M_PI/180.);    
     
     col->PlaceDetector(fLWorld, fPosition, rotate);
+
+    AddExtent("Collimator",
+            G4ThreeVector(-fCollimatorXY/2., -fCollimatorXY/2., 0.),
+            G4ThreeVector( fCollimatorXY/2.,  fCollimatorXY/2., fCollimatorZ + fCollimatorPbZ),
+            rotate);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -245,6 +329,47 @@ void DetectorConstruction::PlaceSample()
     rotate->rotateZ(fRotation.z()*M_PI/180.);    
     
     sample->PlaceDetector(fLWorld, fPosition, rotate);
+    fSampleLogs.push_back(std::make_pair(sample->GetSampleLog(), sample->GetSampleLog()->GetMaterial()));
+
+    AddExtent("Sample",
+            G4ThreeVector(-fSampleRadius, -fSampleRadius, 0.),
+            G4ThreeVector( fSampleRadius,  fSampleRadius, fSampleZ),
+            rotate);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetSampleIn(G4bool in) 
+{
+    // open-beam runs fill the sample volumes with world material instead of
+    // removing them, so navigation (and hence the random number sequence)
+    // stays identical until the first interaction that actually differs
+    G4cout << " ---> Setting sample " << (in ? "in" : "out (open beam)") << G4endl;
+    for (auto& sample : fSampleLogs) {
+        sample.first->SetMaterial(in ? sample.second : GetWorldMaterial());
+    }
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetWorldMaterialName(G4String name) 
+{
+    G4Material* material = G4NistManager::Instance()->FindOrBuildMaterial(name);
+    if (!material) {
+        G4Exception("DetectorConstruction::SetWorldMaterialName()", "Det01", JustWarning,
+                ("unknown material " + name + ", world material unchanged").c_str());
+        return;
+    }
+    fWorldMaterialName = name;
+
+    // the shielding cavity is part of the world volume, so this also
+    // changes what fills the space between the components inside it
+    G4cout << " ---> Setting world material to " << name << G4endl;
+    if (fLWorld) {
+        fLWorld->SetMaterial(material);
+        G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -266,6 +391,17 @@ void DetectorConstruction::PlaceShielding()
     rotate->rotateZ(fRotation.z()*M_PI/180.);    
     
     shield->PlaceDetector(fLWorld, fPosition, rotate);
+
+    // outer faces of the Pb, with the inner PE faces bounding the air cavity
+    G4double outerXY = fShieldingInnerXY/2. + fShieldingBoratedPEThickness + fShieldingPbThickness;
+    G4double outerZ = fShieldingInnerZ + 2.*(fShieldingBoratedPEThickness + fShieldingPbThickness);
+    Extent& ext = AddExtent("Shielding",
+            G4ThreeVector(-outerXY, -outerXY, 0.),
+            G4ThreeVector( outerXY,  outerXY, outerZ),
+            rotate);
+    ext.fHollow = true;
+    ext.fInnerLo = G4ThreeVector(-fShieldingInnerXY/2., -fShieldingInnerXY/2., outerZ/2. - fShieldingInnerZ/2.);
+    ext.fInnerHi = G4ThreeVector( fShieldingInnerXY/2.,  fShieldingInnerXY/2., outerZ/2. + fShieldingInnerZ/2.);
     
     // after shielding is placed, we can set the PV
     G4cout << " ---> Trying to assign shielding tracker physical volume: " << shield->GetTrackerPhys() << G4endl;
@@ -273,3 +409,75 @@ void DetectorConstruction::PlaceShielding()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Material* DetectorConstruction::GetWorldMaterial()
+{
+    return fLWorld ? fLWorld->GetMaterial() : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorConstruction::Extent& DetectorConstruction::AddExtent(const G4String& name, 
+        G4ThreeVector lo, G4ThreeVector hi, G4RotationMatrix* rotate)
+{
+    // assemblies take the rotation in the G4PVPlacement sense, i.e. the
+    // imprint is placed with R^-1, so R itself maps world -> local
+    Extent ext;
+    ext.fName = name;
+    ext.fLo = lo;
+    ext.fHi = hi;
+    ext.fInvRotation = *rotate;
+    ext.fTranslation = fPosition;
+    fExtents.push_back(ext);
+    return fExtents.back();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool DetectorConstruction::IntersectBox(const G4ThreeVector& p, const G4ThreeVector& d,
+        const G4ThreeVector& lo, const G4ThreeVector& hi, G4double& tmin, G4double& tmax)
+{
+    tmin = -DBL_MAX;
+    tmax = DBL_MAX;
+    for (G4int i = 0; i < 3; i++) {
+        if (d[i] == 0.) {
+            if (p[i] < lo[i] || p[i] > hi[i]) return false;
+            continue;
+        }
+        G4double t1 = (lo[i] - p[i]) / d[i];
+        G4double t2 = (hi[i] - p[i]) / d[i];
+        if (t1 > t2) std::swap(t1, t2);
+        tmin = std::max(tmin, t1);
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax) return false;
+    }
+    return tmax >= 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double DetectorConstruction::DistanceToFirstBoundary(const G4ThreeVector& pos, const G4ThreeVector& dir) const
+{
+    // distance a straight ray can travel through world material before it
+    // reaches any placed component; 0 if it starts inside one, kInfinity if
+    // it never meets one
+    G4double dist = kInfinity;
+    for (const auto& ext : fExtents) {
+        G4ThreeVector p = ext.fInvRotation * (pos - ext.fTranslation);
+        G4ThreeVector d = ext.fInvRotation * dir;
+        G4double tmin, tmax;
+        if (!IntersectBox(p, d, ext.fLo, ext.fHi, tmin, tmax)) continue;
+        if (tmin > 0.) {
+            dist = std::min(dist, tmin);
+        }
+        else if (ext.fHollow && IntersectBox(p, d, ext.fInnerLo, ext.fInnerHi, tmin, tmax) && tmin <= 0.) {
+            dist = std::min(dist, tmax);
+        }
+        else {
+            return 0.;
+        }
+    }
+    return dist;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
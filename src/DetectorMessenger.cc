@@ -34,6 +34,7 @@
 
 #include "DetectorConstruction.hh"
 
+#include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWith3Vector.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
@@ -51,6 +52,12 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* Det) : fDetector(Det)
     fDir = new G4UIdirectory("/LDRS/det/");
     fDir->SetGuidance("detector construction commands");
     
+    // world
+    fSetWorldMaterialCmd = new G4UIcmdWithAString("/LDRS/det/setWorldMaterial", this);
+    fSetWorldMaterialCmd->SetGuidance("set world material (e.g. G4_Galactic to drop air scattering)");
+    fSetWorldMaterialCmd->SetParameterName("material", false);
+    fSetWorldMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    
     // placement 
     fSetPositionCmd = new G4UIcmdWith3VectorAndUnit("/LDRS/det/setPosition",this);
     fSetPositionCmd->SetGuidance("set the position of the next volume");
@@ -115,6 +122,11 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* Det) : fDetector(Det)
     fPlaceSampleCmd = new G4UIcmdWithoutParameter("/LDRS/det/placeSample", this);
     fPlaceSampleCmd->SetGuidance("place a sample");
     fPlaceSampleCmd->AvailableForStates(G4State_Idle);
+
+    fSetSampleInCmd = new G4UIcmdWithABool("/LDRS/det/setSampleIn", this);
+    fSetSampleInCmd->SetGuidance("put placed samples in the beam (true) or replace them with world material (false)");
+    fSetSampleInCmd->SetParameterName("in", false);
+    fSetSampleInCmd->AvailableForStates(G4State_Idle);
     
     // detector panel
     fSetDetectorPanelXYCmd  = new G4UIcmdWithADoubleAndUnit("/LDRS/det/setPanelXY", this);
@@ -124,10 +136,28 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction* Det) : fDetector(Det)
     fSetDetectorPanelZCmd   = new G4UIcmdWithADoubleAndUnit("/LDRS/det/setPanelZ", this);
     fSetDetectorPanelZCmd->SetGuidance("set detector panel Z (thickness) dimension");
     //fSetDetectorPanelZCmd->AvailableForStates(G4State_Idle);
+
+    fSetPanelPitchCmd       = new G4UIcmdWithADoubleAndUnit("/LDRS/det/setPanelPitch", this);
+    fSetPanelPitchCmd->SetGuidance("pixelate the detector panel with this pitch (0: one block)");
+    fSetPanelPitchCmd->SetGuidance("the pitch is rounded to tile the panel XY exactly");
+    fSetPanelPitchCmd->SetParameterName("pitch", false);
+    fSetPanelPitchCmd->SetRange("pitch>=0.");
+    fSetPanelPitchCmd->SetDefaultUnit("mm");
+
+    fSetPanelHitRowsCmd     = new G4UIcmdWithABool("/LDRS/det/setPanelHitRows", this);
+    fSetPanelHitRowsCmd->SetGuidance("write one hits ntuple row per hit (pixelated panels also fill hPanelImage)");
+    fSetPanelHitRowsCmd->SetParameterName("rows", false);
+
+    fSetPanelFastSimCmd     = new G4UIcmdWithABool("/LDRS/det/setPanelFastSim", this);
+    fSetPanelFastSimCmd->SetGuidance("absorb contained charged secondaries in the panel in one step");
+    fSetPanelFastSimCmd->SetGuidance("(fast scintillator response, set before /run/initialize)");
+    fSetPanelFastSimCmd->SetParameterName("fast", false);
+    fSetPanelFastSimCmd->AvailableForStates(G4State_PreInit);
     
-    //fPlaceDetectorPanelCmd = new G4UIcmdWithoutParameter("/LDRS/det/placePanel", this);
-    //fPlaceDetectorPanelCmd->SetGuidance("place a detector panel");
-    //fPlaceDetectorPanelCmd->AvailableForStates(G4State_Idle);
+    fPlaceDetectorPanelCmd = new G4UIcmdWithoutParameter("/LDRS/det/placePanel", this);
+    fPlaceDetectorPanelCmd->SetGuidance("place one more detector panel at the current position and rotation");
+    fPlaceDetectorPanelCmd->SetGuidance("(the first panel is placed at /run/initialize)");
+    fPlaceDetectorPanelCmd->AvailableForStates(G4State_Idle);
     
     // shielding
     fSetShieldingInnerXYCmd  = new G4UIcmdWithADoubleAndUnit("/LDRS/det/setShieldingInnerXY", this);
@@ -158,6 +188,8 @@ DetectorMessenger::~DetectorMessenger()
 {
     delete fDir;
     
+    delete fSetWorldMaterialCmd;
+
     delete fSetPositionCmd;
     delete fSetRotationCmd;
     
@@ -176,10 +208,14 @@ DetectorMessenger::~DetectorMessenger()
     delete fSetSampleZCmd;
     delete fSetSampleMaterialNameCmd;
     delete fPlaceSampleCmd;
+    delete fSetSampleInCmd;
     
     delete fSetDetectorPanelXYCmd;
     delete fSetDetectorPanelZCmd;
-    //delete fPlaceDetectorPanelCmd;
+    delete fSetPanelPitchCmd;
+    delete fSetPanelHitRowsCmd;
+    delete fSetPanelFastSimCmd;
+    delete fPlaceDetectorPanelCmd;
     
     delete fSetShieldingInnerXYCmd;
     delete fSetShieldingInnerZCmd;
@@ -193,6 +229,11 @@ DetectorMessenger::~DetectorMessenger()
 
 void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String value)
 {
+    // world
+    if(command == fSetWorldMaterialCmd) {
+        fDetector->SetWorldMaterialName(value);
+    }
+
     // placement
     if(command == fSetPositionCmd) {
         fDetector->SetPosition(fSetPositionCmd->GetNew3VectorValue(value));
@@ -245,6 +286,9 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String value)
     if(command == fPlaceSampleCmd) {
         fDetector->PlaceSample();
     }
+    if(command == fSetSampleInCmd) {
+        fDetector->SetSampleIn(fSetSampleInCmd->GetNewBoolValue(value));
+    }
     
      // detector panel
      if(command == fSetDetectorPanelXYCmd) {
@@ -253,9 +297,18 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String value)
      if(command == fSetDetectorPanelZCmd) {
          fDetector->SetDetectorPanelZ(fSetDetectorPanelZCmd->GetNewDoubleValue(value));
      }
-    // if(command == fPlaceDetectorPanelCmd) {
-    //     fDetector->PlaceDetectorPanel();
-    // }
+     if(command == fSetPanelPitchCmd) {
+         fDetector->SetPanelPitch(fSetPanelPitchCmd->GetNewDoubleValue(value));
+     }
+     if(command == fSetPanelHitRowsCmd) {
+         fDetector->SetPanelHitRows(fSetPanelHitRowsCmd->GetNewBoolValue(value));
+     }
+     if(command == fSetPanelFastSimCmd) {
+         fDetector->SetPanelFastSim(fSetPanelFastSimCmd->GetNewBoolValue(value));
+     }
+     if(command == fPlaceDetectorPanelCmd) {
+         fDetector->PlaceDetectorPanel();
+     }
     
     // shielding
     if(command == fSetShieldingInnerXYCmd) {
@@ -0,0 +1,137 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file Digitizer.cc
+/// \brief Implementation of the Digitizer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "Digitizer.hh"
+#include "DigitizerMessenger.hh"
+
+#include "G4Alpha.hh"
+#include "G4Electron.hh"
+#include "G4EmCalculator.hh"
+#include "G4IonTable.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Material.hh"
+#include "G4Proton.hh"
+#include "Randomize.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Digitizer::Digitizer()
+{
+    fMessenger = new DigitizerMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Digitizer::~Digitizer()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Resolve()
+{
+    if (!fActive) return;
+
+    G4LogicalVolume* scinti = G4LogicalVolumeStore::GetInstance()->GetVolume("ScintiLog", false);
+    if (!scinti) {
+        G4Exception("Digitizer::Resolve()", "Digi01", JustWarning, "no ScintiLog, digitizer off");
+        fActive = false;
+        return;
+    }
+    const G4Material* material = scinti->GetMaterial();
+    G4double kB = fBirks;
+    if (kB < 0.) kB = material->GetIonisation()->GetBirksConstant();
+    if (kB <= 0.) kB = 0.126 * mm / MeV;    // typical of PVT-based plastics
+
+    const G4ParticleDefinition* particles[kNSpecies] = {
+        G4Electron::Definition(), G4Proton::Definition(), G4Alpha::Definition(),
+        G4IonTable::GetIonTable()->GetIon(6, 12, 0.)};
+
+    G4EmCalculator calculator;
+    G4double dLogE = std::log(fEMax / fEMin) / (kNNodes - 1);
+    fInvDLogE = 1. / dLogE;
+    for (G4int s = 0; s < kNSpecies; s++) {
+        std::vector<G4double>& table = fTable[s];
+        table.assign(kNNodes, 0.);
+        G4double previousE = 0., previousYield = 0.;
+        for (G4int k = 0; k < kNNodes; k++) {
+            G4double e = fEMin * std::exp(k * dLogE);
+            G4double dedx = calculator.ComputeTotalDEDX(e, particles[s], material);
+            G4double yield = 1. / (1. + kB * dedx);
+            // below the first node the yield is taken as constant
+            table[k] = (k == 0) ? e * yield : table[k - 1] + 0.5 * (e - previousE) * (yield + previousYield);
+            previousE = e;
+            previousYield = yield;
+        }
+        fTailSlope[s] = previousYield;
+    }
+
+    G4cout << " ---> Digitizer: kB = " << kB / (mm / MeV) << " mm/MeV in " << material->GetName()
+           << ", L(1 MeV) e/p/alpha/C = " << LightOutput(kElectron, MeV) / MeV << "/"
+           << LightOutput(kProton, MeV) / MeV << "/" << LightOutput(kAlpha, MeV) / MeV << "/"
+           << LightOutput(kCarbon, MeV) / MeV << " MeVee" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Digitizer::Process(Batch& batch) const
+{
+    std::size_t n = batch.Size();
+    batch.fLight.resize(n);
+    batch.fDigiTime.resize(n);
+    batch.fAccepted.resize(n);
+
+    for (std::size_t i = 0; i < n; i++) {
+        batch.fLight[i] = LightOutput(batch.fSpecies[i], batch.fEdep[i]);
+    }
+
+    // two standard normals per hit, light then time, in one call
+    if (n > 0 && (fEnergyResolution > 0. || fTimeResolution > 0.)) {
+        batch.fNoise.resize(2 * n);
+        G4RandGauss::shootArray((G4int)(2 * n), batch.fNoise.data(), 0., 1.);
+        for (std::size_t i = 0; i < n; i++) {
+            G4double sigma = fEnergyResolution * std::sqrt(batch.fLight[i] / MeV) * MeV;
+            batch.fLight[i] = std::max(0., batch.fLight[i] + sigma * batch.fNoise[2 * i]);
+            batch.fDigiTime[i] = batch.fTime[i] + fTimeResolution * batch.fNoise[2 * i + 1];
+        }
+    }
+    else {
+        for (std::size_t i = 0; i < n; i++) batch.fDigiTime[i] = batch.fTime[i];
+    }
+
+    for (std::size_t i = 0; i < n; i++) {
+        batch.fAccepted[i] = batch.fLight[i] >= fThreshold;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,120 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file DigitizerMessenger.cc
+/// \brief Implementation of the DigitizerMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "DigitizerMessenger.hh"
+
+#include "Digitizer.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIdirectory.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DigitizerMessenger::DigitizerMessenger(Digitizer* digitizer) : fDigitizer(digitizer)
+{
+    fDir = new G4UIdirectory("/LDRS/digi/");
+    fDir->SetGuidance("scintillator response applied to the panel hits");
+
+    fActiveCmd = new G4UIcmdWithABool("/LDRS/digi/setActive", this);
+    fActiveCmd->SetGuidance("quench, smear and threshold the hits at end of event");
+    fActiveCmd->SetParameterName("active", false);
+    fActiveCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fBirksCmd = new G4UIcmdWithADouble("/LDRS/digi/setBirks", this);
+    fBirksCmd->SetGuidance("Birks constant kB in mm/MeV (< 0: from the panel material)");
+    fBirksCmd->SetParameterName("kB", false);
+    fBirksCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fThresholdCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/digi/setThreshold", this);
+    fThresholdCmd->SetGuidance("electron-equivalent light threshold of a hit");
+    fThresholdCmd->SetParameterName("threshold", false);
+    fThresholdCmd->SetRange("threshold>=0.");
+    fThresholdCmd->SetUnitCategory("Energy");
+    fThresholdCmd->SetDefaultUnit("keV");
+    fThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEnergyResolutionCmd = new G4UIcmdWithADouble("/LDRS/digi/setEnergyResolution", this);
+    fEnergyResolutionCmd->SetGuidance("relative light resolution (sigma) at 1 MeVee, scaling as 1/sqrt(L)");
+    fEnergyResolutionCmd->SetParameterName("resolution", false);
+    fEnergyResolutionCmd->SetRange("resolution>=0.");
+    fEnergyResolutionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTimeResolutionCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/digi/setTimeResolution", this);
+    fTimeResolutionCmd->SetGuidance("Gaussian time resolution (sigma)");
+    fTimeResolutionCmd->SetParameterName("sigma", false);
+    fTimeResolutionCmd->SetRange("sigma>=0.");
+    fTimeResolutionCmd->SetUnitCategory("Time");
+    fTimeResolutionCmd->SetDefaultUnit("ns");
+    fTimeResolutionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DigitizerMessenger::~DigitizerMessenger()
+{
+    delete fActiveCmd;
+    delete fBirksCmd;
+    delete fThresholdCmd;
+    delete fEnergyResolutionCmd;
+    delete fTimeResolutionCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DigitizerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fActiveCmd) {
+        fDigitizer->SetActive(fActiveCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fBirksCmd) {
+        G4double kB = fBirksCmd->GetNewDoubleValue(newValue);
+        fDigitizer->SetBirks(kB < 0. ? -1. : kB * mm / MeV);
+    }
+
+    if (command == fThresholdCmd) {
+        fDigitizer->SetThreshold(fThresholdCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fEnergyResolutionCmd) {
+        fDigitizer->SetEnergyResolution(fEnergyResolutionCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fTimeResolutionCmd) {
+        fDigitizer->SetTimeResolution(fTimeResolutionCmd->GetNewDoubleValue(newValue));
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -20,6 +20,8 @@
 #include "G4AnalysisManager.hh"
 
 #include "ProgressBar.hh"
+#include "EventCost.hh"
+#include "AllocTracker.hh"
 #include "G4Threading.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -39,6 +41,8 @@ EventAction::~EventAction()
 
 void EventAction::BeginOfEventAction(const G4Event* evt)
 {
+    AllocTracker::SetPhase(AllocTracker::kBeginOfEvent);
+
     //fEvtNb = evt->GetEventID();
     //fRunAction->GetProgBar()->Print(fEvtNb);
     
@@ -46,12 +50,21 @@ void EventAction::BeginOfEventAction(const G4Event* evt)
     if(G4Threading::G4GetThreadId() == 0) {
         fRunAction->GetProgBar()->Print(thisEventNumber);
     }
+
+    if (EventCost* cost = fRunAction->GetEventCost()) cost->BeginEvent();
+    if (HitStream::Buffer* stream = fRunAction->GetStreamBuffer()) stream->BeginEvent(evt->GetEventID());
+
+    AllocTracker::SetPhase(AllocTracker::kStepping);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::EndOfEventAction(const G4Event *)
+void EventAction::EndOfEventAction(const G4Event* evt)
 {
+    AllocTracker::SetPhase(AllocTracker::kEndOfEvent);
+
+    if (EventCost* cost = fRunAction->GetEventCost()) cost->EndEvent(evt);
+    if (WeightWindows::Tally* tally = fRunAction->GetWindowTally()) tally->EndEvent();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
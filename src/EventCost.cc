@@ -0,0 +1,187 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file EventCost.cc
+/// \brief Implementation of the EventCost class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "EventCost.hh"
+
+#include "HistoManager.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+static G4bool FasterThan(const EventCost::SlowEvent& a, const EventCost::SlowEvent& b)
+{
+    return a.fTime > b.fTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::BeginEvent()
+{
+    fSteps = 0;
+    fTracks = 0;
+    fSecondaries = 0;
+    fStart = std::chrono::steady_clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::EndEvent(const G4Event* event)
+{
+    std::chrono::duration<G4double> dt = std::chrono::steady_clock::now() - fStart;
+    G4double time = dt.count();
+
+    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    analysis->FillH1(HistoManager::kEventTime, time);
+    analysis->FillH1(HistoManager::kEventSteps, fSteps);
+    analysis->FillH1(HistoManager::kEventTracks, fTracks);
+    analysis->FillH1(HistoManager::kEventSecondaries, fSecondaries);
+
+    fNEvents++;
+    fSumTime += time;
+    fMaxTime = std::max(fMaxTime, time);
+
+    // keep the K slowest; details are only copied for events that get in
+    if ((G4int)fSlowest.size() >= fNSlowest && time <= fSlowest.front().fTime) return;
+    if (fNSlowest <= 0) return;
+
+    SlowEvent slow;
+    slow.fTime = time;
+    slow.fEventID = event->GetEventID();
+    slow.fThread = G4Threading::G4GetThreadId();
+    slow.fSteps = fSteps;
+    slow.fTracks = fTracks;
+    slow.fSecondaries = fSecondaries;
+    slow.fRandomStatus = event->GetRandomNumberStatus();
+    slow.fPairedSeed = fPairedSeed;
+    const G4PrimaryVertex* vertex = event->GetPrimaryVertex();
+    if (vertex && vertex->GetPrimary()) {
+        const G4PrimaryParticle* primary = vertex->GetPrimary();
+        slow.fParticle = primary->GetParticleDefinition()->GetParticleName();
+        slow.fEnergy = primary->GetKineticEnergy();
+        slow.fPosition = vertex->GetPosition();
+        slow.fDirection = primary->GetMomentumDirection();
+        slow.fT0 = vertex->GetT0();
+        slow.fWeight = primary->GetWeight();
+    }
+
+    if ((G4int)fSlowest.size() >= fNSlowest) {
+        std::pop_heap(fSlowest.begin(), fSlowest.end(), FasterThan);
+        fSlowest.pop_back();
+    }
+    fSlowest.push_back(slow);
+    std::push_heap(fSlowest.begin(), fSlowest.end(), FasterThan);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::Merge(const EventCost& other)
+{
+    fNEvents += other.fNEvents;
+    fSumTime += other.fSumTime;
+    fMaxTime = std::max(fMaxTime, other.fMaxTime);
+    // per-thread lists are kept whole
+    fSlowest.insert(fSlowest.end(), other.fSlowest.begin(), other.fSlowest.end());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventCost::Write(const G4String& fileName) const
+{
+    if (fNEvents == 0) return;
+
+    G4cout << "\n Event cost: " << fNEvents << " events, mean " << fSumTime / fNEvents * 1.e3
+        << " ms, max " << fMaxTime * 1.e3 << " ms (distributions in hEvent* histograms)" << G4endl;
+
+    std::vector<SlowEvent> events(fSlowest);
+    std::sort(events.begin(), events.end(), FasterThan);
+
+    std::ofstream out(fileName);
+    if (!out) {
+        G4Exception("EventCost::Write()", "EventCost01", JustWarning, ("cannot open " + fileName).c_str());
+        return;
+    }
+    // replay: paired runs fix an event by its seeds, (seed, eventID + 1),
+    // whatever the thread; otherwise the engine status at the start of the
+    // event goes to its own file, to be restored in a sequential session
+    // (G4RUN_MANAGER_TYPE=Serial, same macro) with /random/resetEngineFrom
+    // <file> then /run/beamOn 1. In MT the status cannot be imposed that
+    // way, as /random/resetEngineFrom acts on the master and each worker
+    // reseeds every event. Phase-space primaries come from ROOT's
+    // per-thread generator unless the run is paired.
+    G4String stem = fileName.substr(0, fileName.find_last_of('.'));
+    out << "# slowest events per thread\n"
+        << "# paired: /LDRS/gun/setPairedSeed <seed>, /run/beamOn <event + 1> (any thread count)\n"
+        << "# otherwise: G4RUN_MANAGER_TYPE=Serial, /random/resetEngineFrom " << stem
+        << "_evt<ID>_t<thread>.rndm, /run/beamOn 1 (Geant4-sampled primaries only)\n";
+    out.precision(10);
+
+    // the G4Event keeps the status in the engine's stream format; passing it
+    // through the master engine writes the file format resetEngineFrom reads
+    std::ostringstream masterStatus;
+    G4Random::saveFullState(masterStatus);
+    for (const auto& slow : events) {
+        out << "event " << slow.fEventID << " thread " << slow.fThread
+            << " time_s " << slow.fTime << " steps " << slow.fSteps
+            << " tracks " << slow.fTracks << " secondaries " << slow.fSecondaries << "\n"
+            << "  primary " << slow.fParticle << " Ekin_MeV " << slow.fEnergy / MeV
+            << " pos_mm " << slow.fPosition.x() / mm << " " << slow.fPosition.y() / mm
+            << " " << slow.fPosition.z() / mm
+            << " dir " << slow.fDirection.x() << " " << slow.fDirection.y() << " " << slow.fDirection.z()
+            << " t0_ns " << slow.fT0 / ns << " weight " << slow.fWeight << "\n";
+        if (slow.fPairedSeed > 0) {
+            out << "  paired seeds " << slow.fPairedSeed << " " << slow.fEventID + 1 << "\n";
+        }
+        else if (!slow.fRandomStatus.empty()) {
+            std::ostringstream name;
+            name << stem << "_evt" << slow.fEventID << "_t" << slow.fThread << ".rndm";
+            std::istringstream status(slow.fRandomStatus);
+            G4Random::restoreFullState(status);
+            G4Random::saveEngineStatus(name.str().c_str());
+        }
+    }
+    std::istringstream restore(masterStatus.str());
+    G4Random::restoreFullState(restore);
+    G4cout << " ---> " << events.size() << " slowest events written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -10,6 +10,7 @@
 #include "G4Cons.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVReplica.hh"
 
 #include "G4SubtractionSolid.hh"
 #include "G4GeometryManager.hh"
@@ -75,13 +76,34 @@ G4int GeometryDetectorPanel::Build()
     rotate = new G4RotationMatrix();
     fDetectorPanelAssembly->AddPlacedVolume(fScintiLog, move, rotate);
 
+    // pixels: columns replicated along x, pixels along y in each column;
+    // copy numbers are (column, row) = (replica 1, replica 0)
+    if (fNPixels > 0) {
+        G4double pitch = fXY / fNPixels;
+        G4Box* sColumn = new G4Box("sScintiColumn", pitch/2., fXY/2., fZ/2.);
+        G4LogicalVolume* columnLog = new G4LogicalVolume(sColumn, material, "ScintiColumnLog");
+        columnLog->SetVisAttributes(G4VisAttributes::GetInvisible());
+        new G4PVReplica("ScintiColumn", columnLog, fScintiLog, kXAxis, fNPixels, pitch);
+
+        G4Box* sPixel = new G4Box("sPixel", pitch/2., pitch/2., fZ/2.);
+        fPixelLog = new G4LogicalVolume(sPixel, material, "PixelLog");
+        fPixelLog->SetVisAttributes(G4VisAttributes::GetInvisible());
+        new G4PVReplica("Pixel", fPixelLog, columnLog, kYAxis, fNPixels, pitch);
+    }
+
     return 1;
 }
 
 G4int GeometryDetectorPanel::PlaceDetector(G4LogicalVolume* logic_world, G4ThreeVector move, G4RotationMatrix* rotate) 
 {
     G4bool surfCheck = true;
+    // the assembly numbers its imprinted volumes base + 1 + i, so the
+    // scintillator of panel i gets copy number i + 1 (panel 0 is the first
+    // daughter of the world, where a base of 0 means the same)
     fDetectorPanelAssembly->MakeImprint(logic_world, move, rotate, fCopyNo, surfCheck);
+    // the scintillator is the only volume of the imprint
+    auto imprinted = fDetectorPanelAssembly->GetVolumesIterator() + (fDetectorPanelAssembly->TotalImprintedVolumes() - 1);
+    fScintiCopyNo = (*imprinted)->GetCopyNo();
     return fCopyNo++;
 }
 
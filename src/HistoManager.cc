@@ -33,11 +33,18 @@
 #include "HistoManager.hh"
 
 #include "RootManager.hh"
+#include "RNtupleOutput.hh"
 
+#include "G4Threading.hh"
 #include "G4UnitsTable.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4ThreadLocal NtupleBuffer* HistoManager::fBuffers[HistoManager::kNtuples] = { nullptr };
+G4bool HistoManager::fNtupleMerging = true;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 HistoManager::HistoManager()
 {
     Book();
@@ -45,6 +52,106 @@ HistoManager::HistoManager()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+HistoManager::~HistoManager()
+{
+    for (G4int i = 0; i < kNtuples; i++) {
+        delete fBuffers[i];
+        fBuffers[i] = nullptr;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int HistoManager::BookNtuple(const G4String& name, const G4String& title,
+                               const std::vector<NtupleBuffer::Column>& columns)
+{
+    // the TTree columns keep the double / int layout the macros read
+    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+    G4int id = analysisManager->CreateNtuple(name, title);
+    for (const auto& column : columns) {
+        if (column.fType == NtupleBuffer::kInt) analysisManager->CreateNtupleIColumn(column.fName);
+        else analysisManager->CreateNtupleDColumn(column.fName);
+    }
+    analysisManager->FinishNtuple();
+
+    delete fBuffers[id];
+    fBuffers[id] = new NtupleBuffer(id, name, columns);
+    return id;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::FlushBuffers()
+{
+    for (G4int i = 0; i < kNtuples; i++) {
+        if (fBuffers[i]) fBuffers[i]->Flush();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetBackend(G4int backend)
+{
+    if (backend == kRNTuple && !RNtupleOutput::IsAvailable()) {
+        G4Exception("HistoManager::SetBackend()", "Histo01", JustWarning,
+                    "built against a ROOT without RNTupleParallelWriter (6.34 or later), keeping TTrees");
+        backend = kTTree;
+    }
+    fBackend = backend;
+
+    // the TTrees are not written at all with the RNTuple backend
+    G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
+    for (G4int id = 0; id < kNtuples; id++) {
+        analysisManager->SetNtupleActivation(id, fBackend == kTTree);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::BeginRun(G4bool master)
+{
+    if (fBackend != kRNTuple) return;
+
+    // next to the analysis file, whose name carries the file number
+    if (master) {
+        G4String fileName = G4AnalysisManager::Instance()->GetFileName();
+        if (G4StrUtil::ends_with(fileName, ".root")) fileName.erase(fileName.size() - 5);
+        RNtupleOutput::Open(fileName + "_rnt.root", fBuffers, kNtuples);
+    }
+    // the master of a multi-threaded run fills nothing
+    if (!master || !G4Threading::IsMultithreadedApplication()) {
+        RNtupleOutput::Attach(fBuffers, kNtuples);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::EndRun(G4bool master)
+{
+    if (fBackend != kRNTuple) return;
+
+    // workers end their run before the master does
+    if (!master || !G4Threading::IsMultithreadedApplication()) {
+        FlushBuffers();
+        RNtupleOutput::Detach(fBuffers, kNtuples);
+    }
+    if (master) RNtupleOutput::Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistoManager::SetNtupleMerging(G4bool val)
+{
+    // workers are built after PreInit and pick the flag up in Book()
+    fNtupleMerging = val;
+    G4AnalysisManager::Instance()->SetNtupleMerging(val);
+    if (!val && G4Threading::IsMasterThread()) {
+        G4cout << " ---> Ntuples unmerged: one file per worker thread, join them with ldrs_merge" << G4endl;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void HistoManager::Book()
 {
     // Create or get analysis manager
@@ -55,7 +162,7 @@ void HistoManager::Book()
     analysisManager->SetFileName(fFileName);
     analysisManager->SetVerboseLevel(1);
     analysisManager->SetActivation(true);  // enable inactivation of histograms
-    analysisManager->SetNtupleMerging(true);
+    analysisManager->SetNtupleMerging(fNtupleMerging);     // /LDRS/run/setNtupleMerging
 
     // check if file number set
     RootManager& rootManager = RootManager::GetInstance();
@@ -71,6 +178,16 @@ void HistoManager::Book()
     idx = analysisManager->CreateH1("hEp", "incident proton energy distrib.", 2000, 0, 20);
     analysisManager->SetH1Activation(idx, true);
     
+    // per-event cost, log binned; activated by /LDRS/run/setEventCost
+    idx = analysisManager->CreateH1("hEventTime", "event wall time [s]", 120, 1.e-6, 1.e3, "none", "none", "log");
+    analysisManager->SetH1Activation(idx, false);
+    idx = analysisManager->CreateH1("hEventSteps", "steps per event", 90, 1., 1.e9, "none", "none", "log");
+    analysisManager->SetH1Activation(idx, false);
+    idx = analysisManager->CreateH1("hEventTracks", "tracks per event", 80, 1., 1.e8, "none", "none", "log");
+    analysisManager->SetH1Activation(idx, false);
+    idx = analysisManager->CreateH1("hEventSecondaries", "secondaries per event", 80, 1., 1.e8, "none", "none", "log");
+    analysisManager->SetH1Activation(idx, false);
+    
     // Ep vs theta
     idx = analysisManager->CreateH2("hEpTheta", "incident proton energy vs theta distrib.", 180, -90, 90, 200, 0, 20);
     analysisManager->SetH2Activation(idx, true);
@@ -79,45 +196,44 @@ void HistoManager::Book()
     idx = analysisManager->CreateH2("hEpCosTheta", "incident proton energy vs cos(theta) distrib.", 1800, -1, 1, 200, 0, 20);
     analysisManager->SetH2Activation(idx, true);
 
+    // image of a pixelated panel (panel frame, mm); binned at begin of run
+    idx = analysisManager->CreateH2("hPanelImage", "weighted hits per pixel", 1, -1., 1., 1, -1., 1.);
+    analysisManager->SetH2Activation(idx, false);
+
+    // next-event and track-length estimates of the same image; /LDRS/est/
+    idx = analysisManager->CreateH2("hPanelImageNEE", "next-event neutron fluence x pixel area", 1, -1., 1., 1, -1., 1.);
+    analysisManager->SetH2Activation(idx, false);
+    idx = analysisManager->CreateH2("hPanelImageTLE", "track-length neutron fluence x pixel area", 1, -1., 1., 1, -1., 1.);
+    analysisManager->SetH2Activation(idx, false);
+
     // ntuple for generating phase space
-    idx = analysisManager->CreateNtuple("tree", "spectrum of outgoing particles");
-    analysisManager->CreateNtupleDColumn("particle");
-    analysisManager->CreateNtupleDColumn("Ekin");
-    analysisManager->CreateNtupleDColumn("t");
-    analysisManager->CreateNtupleDColumn("x");
-    analysisManager->CreateNtupleDColumn("y");
-    analysisManager->CreateNtupleDColumn("z");
-    analysisManager->CreateNtupleDColumn("px");
-    analysisManager->CreateNtupleDColumn("py");
-    analysisManager->CreateNtupleDColumn("pz");
-    analysisManager->FinishNtuple();
+    using Col = NtupleBuffer::Column;
+    const NtupleBuffer::Type D = NtupleBuffer::kDouble, F = NtupleBuffer::kFloat;
+    const NtupleBuffer::Type I = NtupleBuffer::kInt, PDG = NtupleBuffer::kCode;
+    idx = BookNtuple("tree", "spectrum of outgoing particles",
+            {Col{"particle", PDG}, Col{"Ekin", F}, Col{"t", D}, Col{"x", F}, Col{"y", F}, Col{"z", F},
+             Col{"px", F}, Col{"py", F}, Col{"pz", F}, Col{"weight", F}});
     G4cout << " Created ntuple \"tree\" (id " << idx << ") for neutron phase space" << G4endl;
     
     // ntuple for detector hits
-    idx = analysisManager->CreateNtuple("hits", "detector hits");
-    analysisManager->CreateNtupleDColumn("particle");
-    analysisManager->CreateNtupleDColumn("Edep");
-    analysisManager->CreateNtupleDColumn("t");
-    analysisManager->CreateNtupleDColumn("x");
-    analysisManager->CreateNtupleDColumn("y");
-    analysisManager->CreateNtupleDColumn("z");
-    analysisManager->FinishNtuple();
+    idx = BookNtuple("hits", "detector hits",
+            {Col{"particle", PDG}, Col{"Edep", F}, Col{"t", D}, Col{"x", F}, Col{"y", F}, Col{"z", F},
+             Col{"event", I}, Col{"weight", F}, Col{"pixel", I}, Col{"light", F}, Col{"tDigi", D},
+             Col{"panel", I}});
     G4cout << " Created ntuple \"hits\" (id " << idx << ") for detector hits" << G4endl;
     
     // ntuple for generating phase space
-    idx = analysisManager->CreateNtuple("shield", "spectrum of outgoing particles of shielding");
-    analysisManager->CreateNtupleDColumn("particle");
-    analysisManager->CreateNtupleDColumn("Ekin");
-    analysisManager->CreateNtupleDColumn("t");
-    analysisManager->CreateNtupleDColumn("x");
-    analysisManager->CreateNtupleDColumn("y");
-    analysisManager->CreateNtupleDColumn("z");
-    analysisManager->CreateNtupleDColumn("px");
-    analysisManager->CreateNtupleDColumn("py");
-    analysisManager->CreateNtupleDColumn("pz");
-    analysisManager->FinishNtuple();
+    idx = BookNtuple("shield", "spectrum of outgoing particles of shielding",
+            {Col{"particle", PDG}, Col{"Ekin", F}, Col{"t", D}, Col{"x", F}, Col{"y", F}, Col{"z", F},
+             Col{"px", F}, Col{"py", F}, Col{"pz", F}, Col{"weight", F}});
     G4cout << " Created ntuple \"shield\" (id " << idx << ") for shielding tracker" << G4endl;
 
+    // ntuple for user-defined boundary-crossing scorers
+    idx = BookNtuple("crossing", "particles crossing scored boundaries",
+            {Col{"particle", PDG}, Col{"Ekin", F}, Col{"t", D}, Col{"x", F}, Col{"y", F}, Col{"z", F},
+             Col{"px", F}, Col{"py", F}, Col{"pz", F}, Col{"scorer", I}, Col{"weight", F}});
+    G4cout << " Created ntuple \"crossing\" (id " << idx << ") for boundary-crossing scorers" << G4endl;
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
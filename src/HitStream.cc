@@ -0,0 +1,237 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file HitStream.cc
+/// \brief Implementation of the HitStream class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "HitStream.hh"
+#include "HitStreamMessenger.hh"
+
+#include "FlatHashMap.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <thread>
+
+#include "TFile.h"
+#include "TTree.h"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitStream::Buffer::Configure(const HitStream& stream)
+{
+    fParts.clear();
+    if (!stream.IsActive()) {
+        fRecords.reset();
+        return;
+    }
+    fPeriod = stream.fPeriod;
+    fWidth = stream.fWidth;
+    fEventsPerPulse = stream.fEventsPerPulse;
+    fRecords = std::make_shared<std::vector<Record>>();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitStream::Buffer::BeginEvent(G4int eventID)
+{
+    // splitmix64 of the event ID: a uniform number that depends on the
+    // event only, not on which thread runs it
+    std::uint64_t z = (std::uint64_t)eventID + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    G4double u = (z >> 11) * (1. / 9007199254740992.);
+
+    fOffset = (eventID / fEventsPerPulse) * fPeriod + u * fWidth;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitStream::Buffer::Merge(const Buffer& other)
+{
+    if (!other.IsActive()) return;
+    if (!IsActive()) {
+        fPeriod = other.fPeriod;
+        fWidth = other.fWidth;
+        fEventsPerPulse = other.fEventsPerPulse;
+        fRecords = std::make_shared<std::vector<Record>>();
+    }
+    fParts.push_back(other.fRecords);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HitStream::HitStream()
+    : fPeriod(1. * us), fWidth(10. * ns)
+{
+    fMessenger = new HitStreamMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HitStream::~HitStream()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitStream::Process(Buffer& buffer) const
+{
+    if (!buffer.IsActive()) return;
+
+    std::vector<std::shared_ptr<std::vector<Record>>> parts = buffer.fParts;
+    parts.push_back(buffer.fRecords);
+    buffer.fParts.clear();
+
+    // sort each thread's records, one std::thread per buffer
+    auto earlier = [](const Record& a, const Record& b) { return a.fTime < b.fTime; };
+    std::vector<std::thread> threads;
+    for (auto& part : parts) {
+        threads.emplace_back([&part, &earlier]() { std::sort(part->begin(), part->end(), earlier); });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // k-way merge: a min-heap holds the next record of every buffer
+    using Head = std::pair<G4double, std::size_t>;     // time, buffer
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+    std::vector<std::size_t> next(parts.size(), 0);
+    std::size_t nHits = 0;
+    for (std::size_t k = 0; k < parts.size(); k++) {
+        nHits += parts[k]->size();
+        if (!parts[k]->empty()) heap.emplace((*parts[k])[0].fTime, k);
+    }
+
+    struct Channel
+    {
+        G4bool      fOpen = false;
+        G4double    fDeadUntil = -DBL_MAX;
+        Record      fPulse = {};    // counted pulse, light summed over pile-up
+        G4int       fNPile = 0;
+    };
+    FlatHashMap<std::int64_t, Channel> channels;
+    std::vector<Record> counted;
+    std::vector<G4int> piled;
+    std::size_t nLost = 0, nPiled = 0;
+    G4double first = DBL_MAX, last = -DBL_MAX;
+
+    auto emit = [&counted, &piled](const Channel& channel) {
+        counted.push_back(channel.fPulse);
+        piled.push_back(channel.fNPile);
+    };
+
+    while (!heap.empty()) {
+        std::size_t k = heap.top().second;
+        heap.pop();
+        const Record& hit = (*parts[k])[next[k]++];
+        if (next[k] < parts[k]->size()) heap.emplace((*parts[k])[next[k]].fTime, k);
+
+        first = std::min(first, hit.fTime);
+        last = std::max(last, hit.fTime);
+        std::int64_t key = ((std::int64_t)hit.fPanel << 32) | (std::uint32_t)(fPixelChannels ? hit.fPixel : -1);
+        Channel& channel = channels[key];
+
+        // pile-up: adds to the counted pulse
+        if (channel.fOpen && hit.fTime < channel.fPulse.fTime + fPileUpWindow) {
+            channel.fPulse.fLight += hit.fLight;
+            channel.fNPile++;
+            nPiled++;
+            if (fParalyzable) channel.fDeadUntil = std::max(channel.fDeadUntil, hit.fTime + fDeadTime);
+            continue;
+        }
+        // dead: lost, and extends the dead time if paralyzable
+        if (hit.fTime < channel.fDeadUntil) {
+            nLost++;
+            if (fParalyzable) channel.fDeadUntil = hit.fTime + fDeadTime;
+            continue;
+        }
+        if (channel.fOpen) emit(channel);
+        channel.fOpen = true;
+        channel.fPulse = hit;
+        channel.fNPile = 1;
+        channel.fDeadUntil = hit.fTime + fDeadTime;
+    }
+    channels.ForEach([&emit](std::int64_t, const Channel& channel) {
+        if (channel.fOpen) emit(channel);
+    });
+
+    // counted stream, time-ordered
+    std::vector<std::size_t> order(counted.size());
+    for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&counted](std::size_t a, std::size_t b) { return counted[a].fTime < counted[b].fTime; });
+
+    TFile* file = TFile::Open(fFileName.c_str(), "RECREATE");
+    if (!file || file->IsZombie()) {
+        G4Exception("HitStream::Process()", "Stream01", JustWarning, ("cannot open " + fFileName).c_str());
+        delete file;
+    }
+    else {
+        // the file owns the tree and deletes it on Close()
+        auto tree = new TTree("stream", "counted pulses");
+        Double_t t;
+        Float_t light;
+        Int_t panel, pixel, nPile;
+        tree->Branch("t", &t, "t/D");
+        tree->Branch("light", &light, "light/F");
+        tree->Branch("panel", &panel, "panel/I");
+        tree->Branch("pixel", &pixel, "pixel/I");
+        tree->Branch("npile", &nPile, "npile/I");
+        for (std::size_t i : order) {
+            t = counted[i].fTime / ns;
+            light = counted[i].fLight / MeV;
+            panel = counted[i].fPanel;
+            pixel = counted[i].fPixel;
+            nPile = piled[i];
+            tree->Fill();
+        }
+        tree->Write();
+        file->Close();
+        delete file;
+    }
+
+    G4double span = last - first;
+    G4cout << "\n Hit stream (" << parts.size() << " buffers, " << channels.Size() << " channels, dead time "
+           << G4BestUnit(fDeadTime, "Time") << (fParalyzable ? ", paralyzable" : ", non-paralyzable")
+           << ", pile-up window " << G4BestUnit(fPileUpWindow, "Time") << "):"
+           << "\n   hits " << nHits << ", counted " << counted.size() << ", piled up " << nPiled
+           << ", lost to dead time " << nLost;
+    if (span > 0.) {
+        G4cout << "\n   over " << G4BestUnit(span, "Time") << ": true rate " << nHits / (span / s)
+               << " /s, counted rate " << counted.size() / (span / s) << " /s";
+    }
+    G4cout << "\n ---> Counted stream written to " << fFileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
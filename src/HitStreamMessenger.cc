@@ -0,0 +1,161 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file HitStreamMessenger.cc
+/// \brief Implementation of the HitStreamMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "HitStreamMessenger.hh"
+
+#include "HitStream.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HitStreamMessenger::HitStreamMessenger(HitStream* stream) : fStream(stream)
+{
+    fDir = new G4UIdirectory("/LDRS/stream/");
+    fDir->SetGuidance("time-ordered hit stream with pulsed beam, dead time and pile-up");
+
+    fActiveCmd = new G4UIcmdWithABool("/LDRS/stream/setActive", this);
+    fActiveCmd->SetGuidance("build the counted hit stream at end of run");
+    fActiveCmd->SetParameterName("active", false);
+    fActiveCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fPulseCmd = new G4UIcommand("/LDRS/stream/setPulse", this);
+    fPulseCmd->SetGuidance("beam pulse structure: period, width and events per pulse");
+    fPulseCmd->SetGuidance("(width = period for a continuous beam)");
+    fPulseCmd->SetGuidance("[usage] /LDRS/stream/setPulse period width nEvents unit");
+    auto periodPrm = new G4UIparameter("period", 'd', false);
+    periodPrm->SetParameterRange("period>0.");
+    fPulseCmd->SetParameter(periodPrm);
+    auto widthPrm = new G4UIparameter("width", 'd', false);
+    widthPrm->SetParameterRange("width>=0.");
+    fPulseCmd->SetParameter(widthPrm);
+    auto eventsPrm = new G4UIparameter("nEvents", 'i', false);
+    eventsPrm->SetParameterRange("nEvents>0");
+    fPulseCmd->SetParameter(eventsPrm);
+    auto unitPrm = new G4UIparameter("unit", 's', true);
+    unitPrm->SetDefaultUnit("ns");
+    fPulseCmd->SetParameter(unitPrm);
+    fPulseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fDeadTimeCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/stream/setDeadTime", this);
+    fDeadTimeCmd->SetGuidance("dead time of a channel after a counted pulse");
+    fDeadTimeCmd->SetParameterName("tau", false);
+    fDeadTimeCmd->SetRange("tau>=0.");
+    fDeadTimeCmd->SetUnitCategory("Time");
+    fDeadTimeCmd->SetDefaultUnit("ns");
+    fDeadTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fParalyzableCmd = new G4UIcmdWithABool("/LDRS/stream/setParalyzable", this);
+    fParalyzableCmd->SetGuidance("hits during the dead time extend it");
+    fParalyzableCmd->SetParameterName("paralyzable", false);
+    fParalyzableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fPileUpCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/stream/setPileUpWindow", this);
+    fPileUpCmd->SetGuidance("hits this soon after a counted pulse are summed into it");
+    fPileUpCmd->SetParameterName("window", false);
+    fPileUpCmd->SetRange("window>=0.");
+    fPileUpCmd->SetUnitCategory("Time");
+    fPileUpCmd->SetDefaultUnit("ns");
+    fPileUpCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fPixelChannelsCmd = new G4UIcmdWithABool("/LDRS/stream/setPixelChannels", this);
+    fPixelChannelsCmd->SetGuidance("one channel per pixel (false: one per panel)");
+    fPixelChannelsCmd->SetParameterName("pixels", false);
+    fPixelChannelsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fFileCmd = new G4UIcmdWithAString("/LDRS/stream/setFile", this);
+    fFileCmd->SetGuidance("ROOT file for the counted stream");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HitStreamMessenger::~HitStreamMessenger()
+{
+    delete fActiveCmd;
+    delete fPulseCmd;
+    delete fDeadTimeCmd;
+    delete fParalyzableCmd;
+    delete fPileUpCmd;
+    delete fPixelChannelsCmd;
+    delete fFileCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitStreamMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fActiveCmd) {
+        fStream->SetActive(fActiveCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fPulseCmd) {
+        G4double period, width;
+        G4int nEvents;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> period >> width >> nEvents >> unit;
+        G4double u = G4UIcommand::ValueOf(unit);
+        fStream->SetPulse(period * u, width * u, nEvents);
+    }
+
+    if (command == fDeadTimeCmd) {
+        fStream->SetDeadTime(fDeadTimeCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fParalyzableCmd) {
+        fStream->SetParalyzable(fParalyzableCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fPileUpCmd) {
+        fStream->SetPileUpWindow(fPileUpCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fPixelChannelsCmd) {
+        fStream->SetPixelChannels(fPixelChannelsCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fFileCmd) {
+        fStream->SetFileName(newValue);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
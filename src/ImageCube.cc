@@ -0,0 +1,180 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImageCube.cc
+/// \brief Implementation of the ImageCube class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ImageCube.hh"
+
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <cmath>
+#include <thread>
+
+#include "TFile.h"
+#include "TH3F.h"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageCube::Configure(G4int nx, G4int ny, G4int nt, G4double xlo, G4double xhi, G4double ylo, G4double yhi,
+                          G4double tlo, G4double thi, G4bool weighted)
+{
+    fN[0] = nx;
+    fN[1] = ny;
+    fN[2] = nt;
+    fXLo = xlo;
+    fXHi = xhi;
+    fInvX = nx / (xhi - xlo);
+    fYLo = ylo;
+    fYHi = yhi;
+    fInvY = ny / (yhi - ylo);
+    fTLo = tlo;
+    fTHi = thi;
+    fInvT = nt / (thi - tlo);
+    fWeighted = weighted;
+
+    fData = std::make_shared<std::vector<float>>((std::size_t)nx * ny * nt, 0.f);
+    fParts.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageCube::Merge(const ImageCube& other)
+{
+    if (!other.IsConfigured()) return;
+    if (!IsConfigured() || fData->size() != other.fData->size()) {
+        Configure(other.fN[0], other.fN[1], other.fN[2], other.fXLo, other.fXHi, other.fYLo, other.fYHi,
+                  other.fTLo, other.fTHi, other.fWeighted);
+    }
+    // the worker's Run goes away after merging; the shared array does not
+    fParts.push_back(other.fData);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageCube::Reduce()
+{
+    if (fParts.empty()) return;
+
+    std::vector<std::shared_ptr<std::vector<float>>> parts = fParts;
+    parts.push_back(fData);
+    fParts.clear();
+
+    // pass k adds part i + 2^k into part i, for every i multiple of 2^(k+1)
+    for (std::size_t stride = 1; stride < parts.size(); stride *= 2) {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i + stride < parts.size(); i += 2 * stride) {
+            threads.emplace_back([&parts, i, stride]() {
+                std::vector<float>& sum = *parts[i];
+                const std::vector<float>& add = *parts[i + stride];
+                for (std::size_t j = 0; j < sum.size(); j++) sum[j] += add[j];
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+    fData = parts[0];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageCube::Write(const G4String& fileName, G4double flightPath)
+{
+    if (!IsConfigured()) return;
+    Reduce();
+
+    TFile* file = TFile::Open(fileName.c_str(), "RECREATE");
+    if (!file || file->IsZombie()) {
+        G4Exception("ImageCube::Write()", "Cube01", JustWarning, ("cannot open " + fileName).c_str());
+        delete file;
+        return;
+    }
+
+    const std::vector<float>& data = *fData;
+    TH3F hCube("hImageCube", fWeighted ? "weighted hits;x [mm];y [mm];ToF [ns]" : "hits;x [mm];y [mm];ToF [ns]",
+               fN[0], fXLo / mm, fXHi / mm, fN[1], fYLo / mm, fYHi / mm, fN[2], fTLo / ns, fTHi / ns);
+    // owned by this scope, not by the file that deletes its objects on Close()
+    hCube.SetDirectory(nullptr);
+    G4double total = 0.;
+    for (G4int it = 0; it < fN[2]; it++) {
+        for (G4int iy = 0; iy < fN[1]; iy++) {
+            for (G4int ix = 0; ix < fN[0]; ix++) {
+                float value = data[((std::size_t)it * fN[1] + iy) * fN[0] + ix];
+                if (value == 0.f) continue;
+                hCube.SetBinContent(ix + 1, iy + 1, it + 1, value);
+                total += value;
+            }
+        }
+    }
+    hCube.SetEntries(total);
+    hCube.Write();
+
+    // neutron energy from the flight time, E = m (gamma - 1); bins faster
+    // than light are dropped and the axis is reversed to increase
+    if (flightPath > 0.) {
+        G4double tMin = flightPath / c_light;
+        G4double width = (fTHi - fTLo) / fN[2];
+        G4int first = 0;
+        while (first < fN[2] && fTLo + first * width <= tMin) first++;
+
+        G4int nE = fN[2] - first;
+        if (nE > 0) {
+            std::vector<G4double> edges(nE + 1);
+            for (G4int k = 0; k <= nE; k++) {
+                G4double beta = tMin / (fTHi - k * width);
+                edges[k] = neutron_mass_c2 * (1. / std::sqrt(1. - beta * beta) - 1.) / MeV;
+            }
+            // the variable-bin TH3 constructor wants all three axes as edges
+            std::vector<G4double> xEdges(fN[0] + 1), yEdges(fN[1] + 1);
+            for (G4int i = 0; i <= fN[0]; i++) xEdges[i] = (fXLo + i * (fXHi - fXLo) / fN[0]) / mm;
+            for (G4int i = 0; i <= fN[1]; i++) yEdges[i] = (fYLo + i * (fYHi - fYLo) / fN[1]) / mm;
+            TH3F hCubeE("hImageCubeE", "hits;x [mm];y [mm];E_{n} [MeV]",
+                        fN[0], xEdges.data(), fN[1], yEdges.data(), nE, edges.data());
+            hCubeE.SetDirectory(nullptr);
+            for (G4int ie = 0; ie < nE; ie++) {
+                G4int it = fN[2] - 1 - ie;
+                for (G4int iy = 0; iy < fN[1]; iy++) {
+                    for (G4int ix = 0; ix < fN[0]; ix++) {
+                        float value = data[((std::size_t)it * fN[1] + iy) * fN[0] + ix];
+                        if (value != 0.f) hCubeE.SetBinContent(ix + 1, iy + 1, ie + 1, value);
+                    }
+                }
+            }
+            hCubeE.SetEntries(hCubeE.Integral());
+            hCubeE.Write();
+        }
+    }
+    file->Close();
+    delete file;
+
+    G4cout << " ---> Image cube (" << fN[0] << " x " << fN[1] << " x " << fN[2] << ", " << total
+           << (fWeighted ? " weighted" : "") << " hits) written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
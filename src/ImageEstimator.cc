@@ -0,0 +1,284 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImageEstimator.cc
+/// \brief Implementation of the ImageEstimator class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ImageEstimator.hh"
+#include "ImageEstimatorMessenger.hh"
+
+#include "DetectorConstruction.hh"
+#include "PixelImage.hh"
+
+#include "G4HadronicProcess.hh"
+#include "G4HadronicProcessStore.hh"
+#include "G4HadronicProcessType.hh"
+#include "G4Isotope.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4Neutron.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Step.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4UnitsTable.hh"
+#include "G4VTouchable.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImageEstimator::Tracer::Tracer() : fNavigator(new G4Navigator())
+{ }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImageEstimator::Tracer::~Tracer() = default;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ImageEstimator::Tracer::OpticalDepth(const G4ThreeVector& from, const G4ThreeVector& to,
+                                              G4double energy, G4double maxDepth)
+{
+    // the geometry may have been rebuilt since the last run
+    G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()->GetWorldVolume();
+    if (fNavigator->GetWorldVolume() != world) fNavigator->SetWorldVolume(world);
+
+    if (energy != fEnergy) {
+        fSigma.assign(G4Material::GetNumberOfMaterials(), -1.);
+        fEnergy = energy;
+    }
+    G4HadronicProcessStore* store = G4HadronicProcessStore::Instance();
+    const G4ParticleDefinition* neutron = G4Neutron::Definition();
+
+    G4ThreeVector position = from;
+    G4ThreeVector direction = to - from;
+    G4double remaining = direction.mag();
+    if (remaining == 0.) return 0.;
+    direction /= remaining;
+
+    const G4int kMaxSegments = 1000;
+    G4double depth = 0.;
+    G4VPhysicalVolume* volume = fNavigator->LocateGlobalPointAndSetup(position, &direction, false, false);
+    for (G4int i = 0; volume && remaining > 0. && i < kMaxSegments; i++) {
+        G4double safety = 0.;
+        // kInfinity when no boundary is nearer than the end of the ray
+        G4double step = std::min(fNavigator->ComputeStep(position, direction, remaining, safety), remaining);
+
+        const G4Material* material = volume->GetLogicalVolume()->GetMaterial();
+        G4double& sigma = fSigma[material->GetIndex()];
+        if (sigma < 0.) {
+            sigma = store->GetElasticCrossSectionPerVolume(neutron, energy, material)
+                  + store->GetInelasticCrossSectionPerVolume(neutron, energy, material)
+                  + store->GetCaptureCrossSectionPerVolume(neutron, energy, material);
+        }
+        depth += sigma * step;
+        if (depth > maxDepth) break;
+
+        remaining -= step;
+        position += step * direction;
+        fNavigator->SetGeometricallyLimitedStep();
+        volume = fNavigator->LocateGlobalPointAndSetup(position, &direction, true);
+    }
+    return depth;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImageEstimator::ImageEstimator(DetectorConstruction* det) : fDetector(det)
+{
+    fMessenger = new ImageEstimatorMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImageEstimator::~ImageEstimator()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageEstimator::Resolve()
+{
+    fPanels.clear();
+    fPanelOfCopy.clear();
+    fN = 0;
+    if (!IsActive()) return;
+
+    G4int nPixels = fDetector->GetPanelPixels();
+    fPixelated = nPixels > 0;
+    fN = fPixelated ? nPixels : fGrid;
+    fHalfXY = fDetector->GetDetectorPanelXY() / 2.;
+    fPitch = 2. * fHalfXY / fN;
+    fSensitiveLog = G4LogicalVolumeStore::GetInstance()->GetVolume(fPixelated ? "PixelLog" : "ScintiLog", false);
+    if (!fSensitiveLog) {
+        G4Exception("ImageEstimator::Resolve()", "Est01", JustWarning, "no panel volume, estimators off");
+        fNextEvent = fTrackLength = false;
+        fN = 0;
+        return;
+    }
+
+    // pixel centres on the front face of each panel, in the world frame
+    for (const auto& ext : fDetector->GetExtents()) {
+        if (ext.fName != "DetectorPanel") continue;
+        fFront = ext.fLo.z();
+        fThickness = ext.fHi.z() - ext.fLo.z();
+        Panel panel;
+        panel.fToLocal = ext.fInvRotation;
+        panel.fTranslation = ext.fTranslation;
+        G4RotationMatrix toWorld = ext.fInvRotation.inverse();
+        panel.fCentre = toWorld * G4ThreeVector(0., 0., fFront) + ext.fTranslation;
+        panel.fPixels.reserve((std::size_t)fN * fN);
+        for (G4int row = 0; row < fN; row++) {
+            for (G4int column = 0; column < fN; column++) {
+                G4ThreeVector local(-fHalfXY + (column + 0.5) * fPitch, -fHalfXY + (row + 0.5) * fPitch, fFront);
+                panel.fPixels.push_back(toWorld * local + ext.fTranslation);
+            }
+        }
+        if (ext.fCopyNo >= 0) {
+            if (ext.fCopyNo >= (G4int)fPanelOfCopy.size()) fPanelOfCopy.resize(ext.fCopyNo + 1, -1);
+            fPanelOfCopy[ext.fCopyNo] = (G4int)fPanels.size();
+        }
+        fPanels.push_back(panel);
+    }
+
+    G4cout << " ---> Image estimators:" << (fNextEvent ? " next-event" : "")
+           << (fTrackLength ? " track-length" : "") << ", " << fPanels.size() << " panel(s) of "
+           << fN << " x " << fN << " pixels";
+    if (fNextEvent) G4cout << ", exclusion radius " << G4BestUnit(fExclusionRadius, "Length");
+    G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ImageEstimator::AngularDensity(G4double mu, G4double a, G4double& fraction)
+{
+    // mu_cm = ((mu^2 - 1) +- mu sqrt(a^2 - 1 + mu^2)) / a; for a < 1 (hydrogen)
+    // both roots scatter forward, for a > 1 the other one belongs to -mu
+    fraction = 0.;
+    G4double disc = a * a - 1. + mu * mu;
+    if (disc < 0.) return 0.;
+    G4double root = std::sqrt(disc);
+
+    G4double density = 0.;
+    for (G4double sign : {1., -1.}) {
+        G4double muCM = (mu * mu - 1. + sign * mu * root) / a;
+        if (muCM < -1. || muCM > 1.) continue;
+        G4double s2 = a * a + 2. * a * muCM + 1.;
+        if (s2 <= 0.) continue;
+        G4double s = std::sqrt(s2);
+        if (std::abs((1. + a * muCM) / s - mu) > 1.e-6) continue;
+        // d(mu)/d(mu_cm)
+        G4double jacobian = a * a * std::abs(a + muCM) / (s2 * s);
+        if (jacobian <= 0.) continue;
+        if (fraction == 0.) fraction = s2 / ((a + 1.) * (a + 1.));
+        density += 1. / jacobian;
+        if (root == 0.) break;
+    }
+    return density / (4. * pi);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageEstimator::ScoreCollision(const G4Step* aStep, Tracer& tracer, PixelImage* image) const
+{
+    const G4Track* track = aStep->GetTrack();
+    if (track->GetDefinition() != G4Neutron::Definition()) return;
+    const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+    const G4VProcess* process = postPoint->GetProcessDefinedStep();
+    if (!process || process->GetProcessSubType() != fHadronElastic) return;
+
+    auto hproc = dynamic_cast<G4HadronicProcess*>(const_cast<G4VProcess*>(process));
+    const G4Isotope* target = hproc ? hproc->GetTargetIsotope() : nullptr;
+    if (!target) return;
+    G4double a = target->GetA() / (g / mole) * amu_c2 / neutron_mass_c2;
+
+    const G4StepPoint* prePoint = aStep->GetPreStepPoint();
+    const G4ThreeVector& position = postPoint->GetPosition();
+    const G4ThreeVector& direction = prePoint->GetMomentumDirection();
+    G4double energy = prePoint->GetKineticEnergy();
+    G4double scale = prePoint->GetWeight() * fPitch * fPitch;
+    G4double exclusion2 = fExclusionRadius * fExclusionRadius;
+
+    for (std::size_t p = 0; p < fPanels.size(); p++) {
+        const Panel& panel = fPanels[p];
+        // only from in front of the panel: behind its face the track-length
+        // estimator takes over
+        if ((panel.fToLocal * (position - panel.fTranslation)).z() >= fFront) continue;
+
+        G4ThreeVector toCentre = panel.fCentre - position;
+        G4double fraction = 0.;
+        if (AngularDensity(toCentre.unit().dot(direction), a, fraction) == 0.) continue;
+        G4double depth = tracer.OpticalDepth(position, panel.fCentre, fraction * energy, kMaxDepth);
+        if (depth > kMaxDepth) continue;
+        G4double transmitted = scale * std::exp(-depth);
+
+        for (std::size_t i = 0; i < panel.fPixels.size(); i++) {
+            G4ThreeVector toPixel = panel.fPixels[i] - position;
+            G4double r2 = toPixel.mag2();
+            G4double density = AngularDensity(toPixel.dot(direction) / std::sqrt(r2), a, fraction);
+            if (density == 0.) continue;
+            image->Score(PixelImage::kNextEvent, (G4int)i, transmitted * density / std::max(r2, exclusion2));
+        }
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageEstimator::ScoreTrack(const G4Step* aStep, PixelImage* image) const
+{
+    if (aStep->GetTrack()->GetDefinition() != G4Neutron::Definition()) return;
+    const G4StepPoint* prePoint = aStep->GetPreStepPoint();
+    if (prePoint->GetPhysicalVolume()->GetLogicalVolume() != fSensitiveLog) return;
+
+    // pixels from the replica numbers, as in PanelSD; a monolithic panel from
+    // the middle of the step in the panel frame
+    const G4VTouchable* touchable = prePoint->GetTouchable();
+    G4int pixel = 0;
+    if (fPixelated) {
+        pixel = touchable->GetReplicaNumber(0) * fN + touchable->GetReplicaNumber(1);
+    }
+    else {
+        G4int copy = touchable->GetCopyNumber(0);
+        if (copy < 0 || copy >= (G4int)fPanelOfCopy.size() || fPanelOfCopy[copy] < 0) return;
+        const Panel& panel = fPanels[fPanelOfCopy[copy]];
+        G4ThreeVector middle = 0.5 * (prePoint->GetPosition() + aStep->GetPostStepPoint()->GetPosition());
+        G4ThreeVector local = panel.fToLocal * (middle - panel.fTranslation);
+        G4int column = std::clamp((G4int)((local.x() + fHalfXY) / fPitch), 0, fN - 1);
+        G4int row = std::clamp((G4int)((local.y() + fHalfXY) / fPitch), 0, fN - 1);
+        pixel = row * fN + column;
+    }
+    image->Score(PixelImage::kTrackLength, pixel, prePoint->GetWeight() * aStep->GetStepLength() / fThickness);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,107 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImageEstimatorMessenger.cc
+/// \brief Implementation of the ImageEstimatorMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ImageEstimatorMessenger.hh"
+
+#include "ImageEstimator.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImageEstimatorMessenger::ImageEstimatorMessenger(ImageEstimator* estimator) : fEstimator(estimator)
+{
+    fDir = new G4UIdirectory("/LDRS/est/");
+    fDir->SetGuidance("variance-reduced neutron images of the panels");
+
+    fNextEventCmd = new G4UIcmdWithABool("/LDRS/est/setNextEvent", this);
+    fNextEventCmd->SetGuidance("score every neutron elastic collision into the pixels it can reach uncollided");
+    fNextEventCmd->SetGuidance("(hPanelImageNEE)");
+    fNextEventCmd->SetParameterName("active", false);
+    fNextEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTrackLengthCmd = new G4UIcmdWithABool("/LDRS/est/setTrackLength", this);
+    fTrackLengthCmd->SetGuidance("score the neutron track length in the panel per pixel (hPanelImageTLE)");
+    fTrackLengthCmd->SetParameterName("active", false);
+    fTrackLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fExclusionCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/est/setExclusionRadius", this);
+    fExclusionCmd->SetGuidance("distance below which the next-event 1/R^2 is capped");
+    fExclusionCmd->SetParameterName("radius", false);
+    fExclusionCmd->SetRange("radius>0.");
+    fExclusionCmd->SetUnitCategory("Length");
+    fExclusionCmd->SetDefaultUnit("mm");
+    fExclusionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fGridCmd = new G4UIcmdWithAnInteger("/LDRS/est/setGrid", this);
+    fGridCmd->SetGuidance("image bins per side of a monolithic panel (pixelated panels use their pixels)");
+    fGridCmd->SetParameterName("n", false);
+    fGridCmd->SetRange("n>0");
+    fGridCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImageEstimatorMessenger::~ImageEstimatorMessenger()
+{
+    delete fNextEventCmd;
+    delete fTrackLengthCmd;
+    delete fExclusionCmd;
+    delete fGridCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImageEstimatorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fNextEventCmd) {
+        fEstimator->SetNextEvent(fNextEventCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fTrackLengthCmd) {
+        fEstimator->SetTrackLength(fTrackLengthCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fExclusionCmd) {
+        fEstimator->SetExclusionRadius(fExclusionCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fGridCmd) {
+        fEstimator->SetGrid(fGridCmd->GetNewIntValue(newValue));
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,139 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ImportanceBiasing.cc
+/// \brief Implementation of the ImportanceBiasing class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ImportanceBiasing.hh"
+
+#include "BiasingMessenger.hh"
+
+#include "G4LogicalVolumeStore.hh"
+#include "G4SubtractionSolid.hh"
+#include "G4UnitsTable.hh"
+#include "G4VSolid.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImportanceBiasing::ImportanceBiasing()
+{
+    fMessenger = new BiasingMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImportanceBiasing::~ImportanceBiasing()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceBiasing::SetLayer(const G4String& name, G4int nCells, G4double outer, G4double inner)
+{
+    // setting a layer again replaces it
+    auto it = std::find_if(fLayers.begin(), fLayers.end(), 
+                           [&name](const Layer& layer) { return layer.fName == name; });
+    if (it == fLayers.end()) it = fLayers.insert(fLayers.end(), Layer());
+
+    it->fName = name;
+    it->fNCells = std::max(nCells, 1);
+    it->fOuter = outer;
+    it->fInner = inner;
+    it->fImportance.clear();
+    for (G4int i = 0; i < it->fNCells; i++) {
+        G4double f = it->fNCells > 1 ? G4double(i) / (it->fNCells - 1) : 0.;
+        it->fImportance.push_back(outer * std::pow(inner / outer, f));
+    }
+    it->fVolumes.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceBiasing::Clear()
+{
+    fLayers.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceBiasing::List() const
+{
+    G4cout << " ---> Importance layers (max split " << fMaxSplit << "):" << G4endl;
+    for (const auto& layer : fLayers) {
+        G4cout << "   " << layer.fName << ":";
+        for (G4double importance : layer.fImportance) G4cout << " " << importance;
+        G4cout << G4endl;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceBiasing::Resolve()
+{
+    G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+    for (auto& layer : fLayers) {
+        // every logical volume of that name: components share names (the
+        // collimator and the shielding both have a PbLog and a BoratedPELog)
+        layer.fVolumes.clear();
+        for (const G4LogicalVolume* logical : *store) {
+            if (logical->GetName() != layer.fName) continue;
+            Volume cells;
+            cells.fLogical = logical;
+
+            // outer box of the solid, and the cut-out for shells
+            G4VSolid* solid = logical->GetSolid();
+            G4ThreeVector lo, hi;
+            solid->BoundingLimits(lo, hi);
+            cells.fCenter = 0.5 * (lo + hi);
+            cells.fHalf = 0.5 * (hi - lo);
+            cells.fThickness = cells.fHalf;
+            if (auto shell = dynamic_cast<G4SubtractionSolid*>(solid)) {
+                G4ThreeVector innerLo, innerHi;
+                shell->GetConstituentSolid(1)->BoundingLimits(innerLo, innerHi);
+                for (G4int i = 0; i < 3; i++) {
+                    G4double wall = cells.fHalf[i] - 0.5 * (innerHi[i] - innerLo[i]);
+                    // a cut running through the solid leaves no wall on that axis
+                    cells.fThickness[i] = std::max(wall, 0.);
+                }
+            }
+            layer.fVolumes.push_back(cells);
+            G4cout << " ---> Importance layer " << layer.fName << ": " << layer.fNCells 
+                << " cell(s), walls " << G4BestUnit(cells.fThickness, "Length") << G4endl;
+        }
+        if (layer.fVolumes.empty()) {
+            G4Exception("ImportanceBiasing::Resolve()", "Biasing01", JustWarning,
+                    ("no logical volume " + layer.fName + ", layer ignored").c_str());
+        }
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,176 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file KillZoneMessenger.cc
+/// \brief Implementation of the KillZoneMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "KillZoneMessenger.hh"
+
+#include "KillZones.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+KillZoneMessenger::KillZoneMessenger(KillZones* zones) : fZones(zones)
+{
+    fDir = new G4UIdirectory("/LDRS/kill/");
+    fDir->SetGuidance("kill zone commands: tracks entering a zone are stopped");
+
+    fAddBoxCmd = new G4UIcommand("/LDRS/kill/addBox", this);
+    fAddBoxCmd->SetGuidance("kill tracks inside a world-frame box");
+    fAddBoxCmd->SetGuidance("[usage] /LDRS/kill/addBox x y z halfX halfY halfZ unit");
+    for (auto name : {"x", "y", "z", "halfX", "halfY", "halfZ"}) {
+        auto prm = new G4UIparameter(name, 'd', false);
+        fAddBoxCmd->SetParameter(prm);
+    }
+    auto boxUnitPrm = new G4UIparameter("unit", 's', true);
+    boxUnitPrm->SetDefaultUnit("mm");
+    fAddBoxCmd->SetParameter(boxUnitPrm);
+    fAddBoxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fAddCylinderCmd = new G4UIcommand("/LDRS/kill/addCylinder", this);
+    fAddCylinderCmd->SetGuidance("kill tracks inside a cylinder along the world z axis");
+    fAddCylinderCmd->SetGuidance("[usage] /LDRS/kill/addCylinder x y z radius halfZ unit");
+    for (auto name : {"x", "y", "z", "radius", "halfZ"}) {
+        auto prm = new G4UIparameter(name, 'd', false);
+        fAddCylinderCmd->SetParameter(prm);
+    }
+    auto cylUnitPrm = new G4UIparameter("unit", 's', true);
+    cylUnitPrm->SetDefaultUnit("mm");
+    fAddCylinderCmd->SetParameter(cylUnitPrm);
+    fAddCylinderCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fOutsideComponentsCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/kill/outsideComponents", this);
+    fOutsideComponentsCmd->SetGuidance("kill tracks outside the bounding box of all placed components");
+    fOutsideComponentsCmd->SetGuidance("grown by a margin. Resolved at the next beamOn.");
+    fOutsideComponentsCmd->SetParameterName("margin", false);
+    fOutsideComponentsCmd->SetRange("margin>=0.");
+    fOutsideComponentsCmd->SetDefaultUnit("cm");
+    fOutsideComponentsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fClearCmd = new G4UIcmdWithoutParameter("/LDRS/kill/clear", this);
+    fClearCmd->SetGuidance("remove all kill zones");
+    fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fListCmd = new G4UIcmdWithoutParameter("/LDRS/kill/list", this);
+    fListCmd->SetGuidance("list the configured kill zones");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fCullCmd = new G4UIcmdWithABool("/LDRS/kill/cullNeutrals", this);
+    fCullCmd->SetGuidance("cull neutrals entering world air on a line that misses the panels");
+    fCullCmd->SetParameterName("cull", false);
+    fCullCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fCullMarginCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/kill/cullMargin", this);
+    fCullMarginCmd->SetGuidance("margin added around each panel for the culling ray test");
+    fCullMarginCmd->SetParameterName("margin", false);
+    fCullMarginCmd->SetRange("margin>=0.");
+    fCullMarginCmd->SetDefaultUnit("cm");
+    fCullMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fCullSurvivalCmd = new G4UIcmdWithADouble("/LDRS/kill/cullSurvival", this);
+    fCullSurvivalCmd->SetGuidance("Russian roulette survival probability for culled neutrals;");
+    fCullSurvivalCmd->SetGuidance("survivors carry weight 1/p. 0 kills them outright.");
+    fCullSurvivalCmd->SetParameterName("p", false);
+    fCullSurvivalCmd->SetRange("p>=0. && p<=1.");
+    fCullSurvivalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+KillZoneMessenger::~KillZoneMessenger()
+{
+    delete fAddBoxCmd;
+    delete fAddCylinderCmd;
+    delete fOutsideComponentsCmd;
+    delete fClearCmd;
+    delete fListCmd;
+    delete fCullCmd;
+    delete fCullMarginCmd;
+    delete fCullSurvivalCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZoneMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fAddBoxCmd) {
+        G4double x, y, z, hx, hy, hz;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> x >> y >> z >> hx >> hy >> hz >> unit;
+        G4double u = G4UIcommand::ValueOf(unit);
+        fZones->AddBox(G4ThreeVector(x, y, z) * u, G4ThreeVector(hx, hy, hz) * u);
+    }
+
+    if (command == fAddCylinderCmd) {
+        G4double x, y, z, r, hz;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> x >> y >> z >> r >> hz >> unit;
+        G4double u = G4UIcommand::ValueOf(unit);
+        fZones->AddCylinder(G4ThreeVector(x, y, z) * u, r * u, hz * u);
+    }
+
+    if (command == fOutsideComponentsCmd) {
+        fZones->AddOutsideComponents(fOutsideComponentsCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fClearCmd) {
+        fZones->Clear();
+    }
+
+    if (command == fListCmd) {
+        fZones->List();
+    }
+
+    if (command == fCullCmd) {
+        fZones->SetCulling(fCullCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fCullMarginCmd) {
+        fZones->SetCullMargin(fCullMarginCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fCullSurvivalCmd) {
+        fZones->SetCullSurvival(fCullSurvivalCmd->GetNewDoubleValue(newValue));
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
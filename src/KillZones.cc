@@ -0,0 +1,185 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file KillZones.cc
+/// \brief Implementation of the KillZones class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "KillZones.hh"
+
+#include "KillZoneMessenger.hh"
+
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+KillZones::KillZones(DetectorConstruction* det) : fDetector(det)
+{
+    fMessenger = new KillZoneMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+KillZones::~KillZones()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZones::AddBox(const G4ThreeVector& center, const G4ThreeVector& half)
+{
+    Zone zone;
+    zone.fShape = kBox;
+    zone.fCenter = center;
+    zone.fHalf = half;
+    fZones.push_back(zone);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZones::AddCylinder(const G4ThreeVector& center, G4double radius, G4double halfZ)
+{
+    Zone zone;
+    zone.fShape = kCylinder;
+    zone.fCenter = center;
+    zone.fHalf = G4ThreeVector(radius, radius, halfZ);
+    zone.fRadius = radius;
+    fZones.push_back(zone);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZones::AddOutsideComponents(G4double margin)
+{
+    Zone zone;
+    zone.fShape = kOutside;
+    zone.fMargin = margin;
+    // nothing is outside until Resolve() has seen the placed components
+    zone.fLo = G4ThreeVector(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    zone.fHi = G4ThreeVector( DBL_MAX,  DBL_MAX,  DBL_MAX);
+    fZones.push_back(zone);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZones::Clear()
+{
+    fZones.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZones::List() const
+{
+    G4cout << " ---> Kill zones:" << G4endl;
+    for (std::size_t i = 0; i < fZones.size(); i++) {
+        G4cout << "   " << i << ": " << Describe(i) << G4endl;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String KillZones::Describe(std::size_t i) const
+{
+    if (i >= fZones.size()) return "removed zone";
+    const Zone& zone = fZones[i];
+    std::ostringstream os;
+    if (zone.fShape == kBox) {
+        os << "box at " << G4BestUnit(zone.fCenter, "Length")
+            << " half lengths " << G4BestUnit(zone.fHalf, "Length");
+    }
+    else if (zone.fShape == kCylinder) {
+        os << "cylinder at " << G4BestUnit(zone.fCenter, "Length")
+            << " radius " << G4BestUnit(zone.fRadius, "Length")
+            << " half z " << G4BestUnit(zone.fHalf.z(), "Length");
+    }
+    else {
+        os << "outside placed components + " << G4BestUnit(zone.fMargin, "Length");
+    }
+    return os.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void KillZones::Resolve()
+{
+    // world-frame bounding box of all placed components
+    G4ThreeVector lo(DBL_MAX, DBL_MAX, DBL_MAX);
+    G4ThreeVector hi(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+    const auto& extents = fDetector->GetExtents();
+    for (const auto& ext : extents) {
+        G4RotationMatrix toWorld = ext.fInvRotation.inverse();
+        for (G4int corner = 0; corner < 8; corner++) {
+            G4ThreeVector local((corner & 1) ? ext.fHi.x() : ext.fLo.x(),
+                                (corner & 2) ? ext.fHi.y() : ext.fLo.y(),
+                                (corner & 4) ? ext.fHi.z() : ext.fLo.z());
+            G4ThreeVector world = toWorld * local + ext.fTranslation;
+            for (G4int i = 0; i < 3; i++) {
+                lo[i] = std::min(lo[i], world[i]);
+                hi[i] = std::max(hi[i], world[i]);
+            }
+        }
+    }
+
+    // components and panels for directional culling
+    fComponents = extents;
+    fPanels.clear();
+    G4ThreeVector grow(fCullMargin, fCullMargin, fCullMargin);
+    for (const auto& ext : extents) {
+        if (ext.fName != "DetectorPanel") continue;
+        fPanels.push_back(ext);
+        fPanels.back().fLo -= grow;
+        fPanels.back().fHi += grow;
+    }
+    if (fCulling) {
+        G4cout << " ---> Culling neutrals that miss " << fPanels.size() << " panel(s) by more than "
+            << G4BestUnit(fCullMargin, "Length") << " (survival " << fCullSurvival << ")" << G4endl;
+    }
+
+    for (auto& zone : fZones) {
+        if (zone.fShape != kOutside) continue;
+        if (extents.empty()) {
+            G4Exception("KillZones::Resolve()", "KillZone01", JustWarning,
+                    "no placed components, outside-components kill zone disabled");
+            zone.fLo = G4ThreeVector(-DBL_MAX, -DBL_MAX, -DBL_MAX);
+            zone.fHi = G4ThreeVector( DBL_MAX,  DBL_MAX,  DBL_MAX);
+            continue;
+        }
+        G4ThreeVector margin(zone.fMargin, zone.fMargin, zone.fMargin);
+        zone.fLo = lo - margin;
+        zone.fHi = hi + margin;
+        G4cout << " ---> Killing tracks outside " << G4BestUnit(zone.fLo, "Length")
+            << " -> " << G4BestUnit(zone.fHi, "Length") << G4endl;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ListModeMessenger.cc
+/// \brief Implementation of the ListModeMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ListModeMessenger.hh"
+
+#include "ListModeWriter.hh"
+
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIdirectory.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ListModeMessenger::ListModeMessenger(ListModeWriter* writer) : fWriter(writer)
+{
+    fDir = new G4UIdirectory("/LDRS/list/");
+    fDir->SetGuidance("binary list-mode output of the panel hits");
+
+    fActiveCmd = new G4UIcmdWithABool("/LDRS/list/setActive", this);
+    fActiveCmd->SetGuidance("write one list-mode file per thread and run");
+    fActiveCmd->SetParameterName("active", false);
+    fActiveCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fFileCmd = new G4UIcmdWithAString("/LDRS/list/setFileStem", this);
+    fFileCmd->SetGuidance("file stem; files are <stem>_r<run>_t<thread>.lmd and .idx");
+    fFileCmd->SetParameterName("stem", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTickCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/list/setTimeTick", this);
+    fTickCmd->SetGuidance("time quantum of the delta-encoded timestamps");
+    fTickCmd->SetParameterName("tick", false);
+    fTickCmd->SetRange("tick>0.");
+    fTickCmd->SetUnitCategory("Time");
+    fTickCmd->SetDefaultUnit("ps");
+    fTickCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fQuantumCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/list/setPositionQuantum", this);
+    fQuantumCmd->SetGuidance("x/y quantum on monolithic panels (pixelated: column and row)");
+    fQuantumCmd->SetParameterName("quantum", false);
+    fQuantumCmd->SetRange("quantum>0.");
+    fQuantumCmd->SetUnitCategory("Length");
+    fQuantumCmd->SetDefaultUnit("mm");
+    fQuantumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEnergyLSBCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/list/setEnergyLSB", this);
+    fEnergyLSBCmd->SetGuidance("energy of one unit of the 16-bit light field");
+    fEnergyLSBCmd->SetParameterName("lsb", false);
+    fEnergyLSBCmd->SetRange("lsb>0.");
+    fEnergyLSBCmd->SetUnitCategory("Energy");
+    fEnergyLSBCmd->SetDefaultUnit("keV");
+    fEnergyLSBCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fIndexStrideCmd = new G4UIcmdWithAnInteger("/LDRS/list/setIndexStride", this);
+    fIndexStrideCmd->SetGuidance("index every N-th event written");
+    fIndexStrideCmd->SetParameterName("N", false);
+    fIndexStrideCmd->SetRange("N>0");
+    fIndexStrideCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ListModeMessenger::~ListModeMessenger()
+{
+    delete fActiveCmd;
+    delete fFileCmd;
+    delete fTickCmd;
+    delete fQuantumCmd;
+    delete fEnergyLSBCmd;
+    delete fIndexStrideCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ListModeMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fActiveCmd) {
+        fWriter->SetActive(fActiveCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fFileCmd) {
+        fWriter->SetFileStem(newValue);
+    }
+
+    if (command == fTickCmd) {
+        fWriter->SetTimeTick(fTickCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fQuantumCmd) {
+        fWriter->SetPositionQuantum(fQuantumCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fEnergyLSBCmd) {
+        fWriter->SetEnergyLSB(fEnergyLSBCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fIndexStrideCmd) {
+        fWriter->SetIndexStride(fIndexStrideCmd->GetNewIntValue(newValue));
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
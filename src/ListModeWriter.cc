@@ -0,0 +1,196 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ListModeWriter.cc
+/// \brief Implementation of the ListModeWriter class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ListModeWriter.hh"
+#include "ListModeMessenger.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+static const std::size_t kBufferRecords = 1 << 16;    // 768 kB per write
+static const std::size_t kHeaderBytes = 48;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ListModeWriter::ListModeWriter()
+    : fTick(10. * picosecond), fQuantum(0.01 * mm), fEnergyLSB(1. * keV)
+{
+    fMessenger = new ListModeMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ListModeWriter::~ListModeWriter()
+{
+    Close();
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ListModeWriter::Open(G4int runID, G4int nPixels)
+{
+    Close();
+    if (!fActive) return;
+
+    std::ostringstream name;
+    name << fFileStem << "_r" << runID << "_t" << G4Threading::G4GetThreadId();
+    fFileName = name.str();
+    fOut.open(fFileName + ".lmd", std::ios::binary | std::ios::trunc);
+    if (!fOut) {
+        G4Exception("ListModeWriter::Open()", "ListMode01", JustWarning,
+                ("cannot open " + fFileName + ".lmd, list mode off").c_str());
+        return;
+    }
+
+    // header: magic, version, record size, pixels per side, then the
+    // quantization as doubles in ps, mm and keV
+    char header[kHeaderBytes] = {};
+    std::memcpy(header, "LDRSLMD", 8);
+    std::int32_t fields[3] = {1, (std::int32_t)sizeof(Record), nPixels};
+    std::memcpy(header + 8, fields, sizeof(fields));
+    G4double units[3] = {fTick / picosecond, fQuantum / mm, fEnergyLSB / keV};
+    std::memcpy(header + 24, units, sizeof(units));
+    fOut.write(header, kHeaderBytes);
+
+    fNPixels = nPixels;
+    fBuffer.clear();
+    fBuffer.reserve(kBufferRecords);
+    fIndex.clear();
+    fNRecords = 0;
+    fNMarkers = 0;
+    fEvent = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ListModeWriter::Close()
+{
+    if (!IsOpen()) return;
+
+    Flush();
+    fOut.close();
+
+    std::ofstream index(fFileName + ".idx", std::ios::binary | std::ios::trunc);
+    index.write((const char*)fIndex.data(), fIndex.size() * sizeof(std::int64_t));
+
+    G4cout << " ---> List mode: " << fNRecords << " records (" << fNMarkers << " events, "
+           << (kHeaderBytes + fNRecords * sizeof(Record)) / 1024 << " kB) written to " << fFileName
+           << ".lmd" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ListModeWriter::Add(G4int eventID, G4double beamTime, G4int panel, G4int pixel, const G4ThreeVector& pos,
+                         G4double time, G4double light, G4int pdg)
+{
+    if (eventID != fEvent) {
+        if (fNMarkers % fIndexStride == 0) {
+            fIndex.push_back(eventID);
+            fIndex.push_back(kHeaderBytes + fNRecords * sizeof(Record));
+        }
+        std::uint64_t beamNs = (std::uint64_t)std::max(0., beamTime / ns);
+        Record marker;
+        marker.fDelta = eventID;
+        marker.fX = (std::uint16_t)(beamNs >> 32);
+        marker.fY = (std::uint16_t)(beamNs >> 16);
+        marker.fEnergy = (std::uint16_t)beamNs;
+        marker.fSpecies = kMarker;
+        marker.fPanel = kMarker;
+        Put(marker);
+        fNMarkers++;
+        fEvent = eventID;
+        fLastTick = 0;
+    }
+
+    auto quantize = [this](G4double x) {
+        return (std::uint16_t)std::min(std::max(std::lround(x / fQuantum) + 32768l, 0l), 65535l);
+    };
+
+    Record hit;
+    std::int64_t tick = std::llround(time / fTick);
+    hit.fDelta = (std::int32_t)std::min(std::max(tick - fLastTick, (std::int64_t)INT32_MIN), (std::int64_t)INT32_MAX);
+    fLastTick += hit.fDelta;
+    if (fNPixels > 0 && pixel >= 0) {
+        hit.fX = (std::uint16_t)(pixel % fNPixels);
+        hit.fY = (std::uint16_t)(pixel / fNPixels);
+    }
+    else {
+        hit.fX = quantize(pos.x());
+        hit.fY = quantize(pos.y());
+    }
+    hit.fEnergy = (std::uint16_t)std::min(std::lround(std::max(light, 0.) / fEnergyLSB), 65535l);
+    hit.fSpecies = Species(pdg);
+    hit.fPanel = (std::uint8_t)std::min(panel, 254);
+    Put(hit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ListModeWriter::Put(const Record& record)
+{
+    fBuffer.push_back(record);
+    fNRecords++;
+    if (fBuffer.size() == kBufferRecords) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ListModeWriter::Flush()
+{
+    fOut.write((const char*)fBuffer.data(), fBuffer.size() * sizeof(Record));
+    fBuffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::uint8_t ListModeWriter::Species(G4int pdg)
+{
+    switch (pdg) {
+        case 11: case -11:              return kElectron;
+        case 22:                        return kGamma;
+        case 2212:                      return kProton;
+        case 1000010020:                return kDeuteron;
+        case 1000010030:                return kTriton;
+        case 1000020030: case 1000020040:   return kHelium;
+        default:                        return pdg > 1000020040 ? kIon : kOther;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file NtupleBuffer.cc
+/// \brief Implementation of the NtupleBuffer class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "NtupleBuffer.hh"
+
+#include "RNtupleOutput.hh"
+
+#include "G4AnalysisManager.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NtupleBuffer::NtupleBuffer(G4int ntupleId, const G4String& name, const std::vector<Column>& columns,
+                           std::size_t capacity)
+    : fNtupleId(ntupleId), fName(name), fColumns(columns), fNColumns((G4int)columns.size()), fCapacity(capacity)
+{
+    fData.resize(fNColumns * fCapacity);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NtupleBuffer::Flush()
+{
+    if (fRows == 0) return;
+
+    if (fRNtuple) {
+        RNtupleOutput::Fill(*this);
+        fRows = 0;
+        return;
+    }
+
+    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    for (std::size_t row = 0; row < fRows; row++) {
+        for (G4int col = 0; col < fNColumns; col++) {
+            G4double val = fData[col * fCapacity + row];
+            if (fColumns[col].fType == kInt)
+                analysis->FillNtupleIColumn(fNtupleId, col, (G4int)val);
+            else
+                analysis->FillNtupleDColumn(fNtupleId, col, val);
+        }
+        analysis->AddNtupleRow(fNtupleId);
+    }
+    fRows = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -36,9 +36,16 @@
 #include "G4Track.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4ThreeVector.hh"
+#include "G4VTouchable.hh"
 #include "G4ios.hh"
 
-#include "G4AnalysisManager.hh"
+#include "HistoManager.hh"
+#include "Run.hh"
+#include "TrackingAction.hh"
+#include "ListModeWriter.hh"
+#include "G4RunManager.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -50,6 +57,16 @@ PanelSD::PanelSD(const G4String& name, const G4String& hitsCollectionName)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PanelSD::SetPixels(G4int n)
+{
+    fNPixels = n;
+    fSlotsPerPanel = n > 0 ? n * n : 1;
+    fSlots.assign(fSlotsPerPanel, HitSlot());
+    fTouched.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void PanelSD::Initialize(G4HCofThisEvent* hce)
 {
     // Create hits collection
@@ -58,6 +75,8 @@ void PanelSD::Initialize(G4HCofThisEvent* hce)
     // Add this collection in hce
     G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
     hce->AddHitsCollection(hcID, fHitsCollection);
+
+    fTracking = dynamic_cast<const TrackingAction*>(G4EventManager::GetEventManager()->GetUserTrackingAction());
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -76,46 +95,70 @@ G4bool PanelSD::ProcessHits(G4Step* step, G4TouchableHistory*)
     // time
     G4double t = step->GetPreStepPoint()->GetGlobalTime();
 
-    // if not triggered yet
-    if(!fTrig) {
-        auto newHit = new PanelHit();
-        newHit->SetTrackID(step->GetTrack()->GetTrackID());
-        newHit->SetEdep(edep);
-        newHit->SetPos(step->GetPostStepPoint()->GetPosition());
-        newHit->SetTime(t);
-        newHit->SetPID(step->GetTrack()->GetParticleDefinition()->GetPDGEncoding());
-        fHitsCollection->insert(newHit);
-
-        //G4cout << "inserting new hit" << G4endl;
+    // first hit per panel and pixel: the panel from the copy number of its
+    // scintillator, the pixel from the replica copy numbers
+    const G4VTouchable* touchable = step->GetPreStepPoint()->GetTouchable();
+    G4int index = 0;
+    if (fNPixels > 0) {
+        index = (touchable->GetCopyNumber(2) - 1) * fSlotsPerPanel
+              + touchable->GetReplicaNumber(0) * fNPixels + touchable->GetReplicaNumber(1);
     }
-    // if triggered, but this step has smaller timestamp than hit 
-    else if(fTrig && t < ((PanelHit*)fHitsCollection->GetHit(0))->GetTime()) {
-        auto oldHit = (PanelHit*)fHitsCollection->GetHit(0);
-        oldHit->SetTrackID(step->GetTrack()->GetTrackID());
-        oldHit->AddEdep(edep);
-        oldHit->SetPos(step->GetPostStepPoint()->GetPosition());
-        oldHit->SetTime(t);
-        oldHit->SetPID(step->GetTrack()->GetParticleDefinition()->GetPDGEncoding());
-        
-        //G4cout << "updating old hit with new time/pos" << G4endl;
+    else {
+        index = touchable->GetCopyNumber(0) - 1;
     }
-    else { // triggered and time greater, just add edep
-        auto oldHit = (PanelHit*)fHitsCollection->GetHit(0);
-        oldHit->AddEdep(edep);
-        
-        //G4cout << "updating old hit by just summing the edeps" << G4endl;
+    if (index >= (G4int)fSlots.size()) fSlots.resize(index + 1);
+
+    // split copies carry a share of the weight: merging them into one slot
+    // would keep one copy's weight for the summed deposit of all of them
+    G4int branch = fTracking ? fTracking->GetBranch(step->GetTrack()->GetTrackID()) : 0;
+    HitSlot& slot = branch == 0 ? fSlots[index] : fBranchSlots[((std::int64_t)branch << 32) | index];
+    if (branch == 0 && slot.fTime == DBL_MAX) fTouched.push_back(index);
+    if (t < slot.fTime) {
+        slot.fTime = t;
+        slot.fPos = step->GetPostStepPoint()->GetPosition();
+        slot.fTrackID = step->GetTrack()->GetTrackID();
+        slot.fPID = step->GetTrack()->GetParticleDefinition()->GetPDGEncoding();
+        slot.fWeight = step->GetTrack()->GetWeight();
     }
-
-    // set triggered to true
-    fTrig = true;
+    slot.fEdep += edep;
 
     return true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PanelSD::AddHit(G4int index, const HitSlot& slot)
+{
+    auto hit = new PanelHit();
+    hit->SetTrackID(slot.fTrackID);
+    hit->SetEdep(slot.fEdep);
+    hit->SetPos(slot.fPos);
+    hit->SetTime(slot.fTime);
+    hit->SetPID(slot.fPID);
+    hit->SetWeight(slot.fWeight);
+    hit->SetPixel(fNPixels > 0 ? index % fSlotsPerPanel : -1);
+    hit->SetPanel(index / fSlotsPerPanel);
+    fHitsCollection->insert(hit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void PanelSD::EndOfEvent(G4HCofThisEvent*)
 {
+    // one hit per panel (and pixel) touched in this event, and per split
+    // branch that reached it
+    for (G4int index : fTouched) {
+        AddHit(index, fSlots[index]);
+        fSlots[index] = HitSlot();
+    }
+    fTouched.clear();
+    if (!fBranchSlots.Empty()) {
+        fBranchSlots.ForEach([this](std::int64_t key, const HitSlot& slot) {
+            AddHit((G4int)(key & 0xffffffff), slot);
+        });
+        fBranchSlots.Clear();
+    }
+
     std::size_t nofHits = fHitsCollection->entries();
     
     if (verboseLevel > 1) {
@@ -125,25 +168,64 @@ void PanelSD::EndOfEvent(G4HCofThisEvent*)
             (*fHitsCollection)[i]->Print();
     }
 
-    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    // weight-window pilot: the weighted hits are the tally being optimised
+    Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    WeightWindows::Tally* tally = run->GetWindowTally();
+    PixelImage* image = run->GetPixelImage();
+    ImageCube* cube = run->GetImageCube();
+    HitStream::Buffer* stream = run->GetStreamBuffer();
+    ListModeWriter* listMode = run->GetListModeWriter();
+
+    // detector response, over all the hits of the event at once; only
+    // hits above threshold go further
+    G4bool digitize = fDigitizer && fDigitizer->IsActive();
+    if (digitize) {
+        fBatch.Clear();
+        for (std::size_t i = 0; i < nofHits; i++) {
+            const PanelHit* hit = (*fHitsCollection)[i];
+            fBatch.Add(hit->GetPID(), hit->GetEdep(), hit->GetTime());
+        }
+        fDigitizer->Process(fBatch);
+    }
+
+    NtupleBuffer* buffer = HistoManager::GetBuffer(HistoManager::kHits);
+    G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
     for (std::size_t i = 0; i < nofHits; i++) {
-        G4double pid        = (*fHitsCollection)[i]->GetPID();
-        G4double edep       = (*fHitsCollection)[i]->GetEdep();
-        G4double t          = (*fHitsCollection)[i]->GetTime();
-        G4ThreeVector pos   = (*fHitsCollection)[i]->GetPos();
+        const PanelHit* hit = (*fHitsCollection)[i];
+        const G4ThreeVector& pos = hit->GetPos();
+        G4double light = hit->GetEdep();
+        G4double time = hit->GetTime();
+        if (digitize) {
+            if (!fBatch.IsAccepted(i)) continue;
+            light = fBatch.GetLight(i);
+            time = fBatch.GetTime(i);
+        }
         
+        if (tally->IsActive()) tally->Score(hit->GetWeight());
+        if (hit->GetPixel() >= 0) image->Fill(hit->GetPixel(), hit->GetWeight(), hit->GetEdep());
+        if (cube->IsConfigured()) cube->Fill(pos.x(), pos.y(), time, hit->GetWeight());
+        if (stream->IsActive()) stream->Add(hit->GetPanel(), hit->GetPixel(), time, light);
+        if (listMode) {
+            listMode->Add(eventID, stream->IsActive() ? stream->GetOffset() : 0., hit->GetPanel(), hit->GetPixel(),
+                          pos, time, light, hit->GetPID());
+        }
+        if (!fHitRows) continue;
+
         // 2nd ntuple is for panel hits
-        G4int idx = 1;
-        analysis->FillNtupleDColumn(idx, 0, pid);
-        analysis->FillNtupleDColumn(idx, 1, edep);
-        analysis->FillNtupleDColumn(idx, 2, t);
-        analysis->FillNtupleDColumn(idx, 3, pos.x());
-        analysis->FillNtupleDColumn(idx, 4, pos.y());
-        analysis->FillNtupleDColumn(idx, 5, pos.z());
-        analysis->AddNtupleRow(idx);
+        std::size_t row = buffer->NextRow();
+        buffer->Set(0, row, hit->GetPID());
+        buffer->Set(1, row, hit->GetEdep());
+        buffer->Set(2, row, hit->GetTime());
+        buffer->Set(3, row, pos.x());
+        buffer->Set(4, row, pos.y());
+        buffer->Set(5, row, pos.z());
+        buffer->Set(6, row, eventID);
+        buffer->Set(7, row, hit->GetWeight());
+        buffer->Set(8, row, hit->GetPixel());
+        buffer->Set(9, row, light);
+        buffer->Set(10, row, time);
+        buffer->Set(11, row, hit->GetPanel());
     }
-
-    fTrig = false;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -30,6 +30,7 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "PhysicsList.hh"
+#include "DetectorConstruction.hh"
 
 #include "GammaNuclearPhysics.hh"
 #include "GammaNuclearPhysicsLEND.hh"
@@ -70,6 +71,7 @@
 #include "G4IonPhysicsXS.hh"
 #include "GammaNuclearPhysics.hh"
 #include "G4NuclideTable.hh"
+#include "G4FastSimulationPhysics.hh"
 
 
 
@@ -77,7 +79,8 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-PhysicsList::PhysicsList()
+PhysicsList::PhysicsList(const DetectorConstruction* det)
+: fDetector(det)
 {
     G4int verb = 1;
     SetVerboseLevel(verb);
@@ -132,7 +135,26 @@ PhysicsList::PhysicsList()
     RegisterPhysics(new G4IonElasticPhysics(verb));
     RegisterPhysics(new G4IonPhysicsXS(verb));
     RegisterPhysics(new GammaNuclearPhysics("gamma"));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PhysicsList::ConstructProcess()
+{
+    G4VModularPhysicsList::ConstructProcess();
+
+    // fast simulation process for the charged secondaries that
+    // ScintiFastModel may absorb, only when the model is attached.
+    // /LDRS/det/setPanelFastSim is PreInit only, so the flag is final here,
+    // but it comes after the constructor: the physics is built in place
+    // rather than registered
+    if (fDetector && fDetector->GetPanelFastSim()) {
+        G4FastSimulationPhysics fastSimulation;
+        for (auto name : {"e-", "proton", "deuteron", "triton", "He3", "alpha", "GenericIon"}) {
+            fastSimulation.ActivateFastSimulation(name);
+        }
+        fastSimulation.ConstructProcess();
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
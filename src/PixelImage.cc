@@ -0,0 +1,109 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file PixelImage.cc
+/// \brief Implementation of the PixelImage class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "PixelImage.hh"
+
+#include "G4AnalysisManager.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelImage::Configure(G4int n, G4double halfXY)
+{
+    fN = n;
+    fHalfXY = halfXY;
+    fCounts.assign((std::size_t)n * n, 0.);
+    fEdep.assign((std::size_t)n * n, 0.);
+    for (auto& estimate : fEstimate) estimate.assign((std::size_t)n * n, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelImage::Merge(const PixelImage& other)
+{
+    if (!other.IsConfigured()) return;
+    if (fCounts.size() != other.fCounts.size()) Configure(other.fN, other.fHalfXY);
+    for (std::size_t i = 0; i < fCounts.size(); i++) {
+        fCounts[i] += other.fCounts[i];
+        fEdep[i] += other.fEdep[i];
+        for (G4int e = 0; e < kNEstimators; e++) fEstimate[e][i] += other.fEstimate[e][i];
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelImage::FillH2(G4int id) const
+{
+    if (!IsConfigured()) return;
+
+    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    G4double pitch = 2. * fHalfXY / fN;
+    G4double total = 0., edep = 0.;
+    for (G4int row = 0; row < fN; row++) {
+        for (G4int column = 0; column < fN; column++) {
+            G4double counts = fCounts[row * fN + column];
+            if (counts == 0.) continue;
+            G4double x = -fHalfXY + (column + 0.5) * pitch;
+            G4double y = -fHalfXY + (row + 0.5) * pitch;
+            analysis->FillH2(id, x / mm, y / mm, counts);
+            total += counts;
+            edep += fEdep[row * fN + column];
+        }
+    }
+    G4cout << "\n Panel image: " << fN << " x " << fN << " pixels, " << total << " weighted hits";
+    if (total > 0.) G4cout << ", mean Edep " << edep / total / MeV << " MeV";
+    G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelImage::FillH2(G4int id, G4int estimator) const
+{
+    if (!IsConfigured()) return;
+
+    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    G4double pitch = 2. * fHalfXY / fN;
+    G4double total = 0.;
+    const std::vector<G4double>& estimate = fEstimate[estimator];
+    for (G4int row = 0; row < fN; row++) {
+        for (G4int column = 0; column < fN; column++) {
+            G4double value = estimate[row * fN + column];
+            if (value == 0.) continue;
+            analysis->FillH2(id, (-fHalfXY + (column + 0.5) * pitch) / mm, (-fHalfXY + (row + 0.5) * pitch) / mm, value);
+            total += value;
+        }
+    }
+    G4cout << " Panel image, " << (estimator == kNextEvent ? "next-event" : "track-length")
+           << " estimate: " << total << " (fluence x pixel area, summed)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
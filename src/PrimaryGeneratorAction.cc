@@ -38,6 +38,9 @@
 #include "PrimaryGeneratorMessenger.hh"
 
 #include "G4Event.hh"
+#include "G4HadronicProcessStore.hh"
+#include "G4Material.hh"
+#include "G4PhysicalConstants.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4ParticleTable.hh"
 #include "G4SystemOfUnits.hh"
@@ -101,6 +104,13 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
     G4AnalysisManager* analysis = G4AnalysisManager::Instance();
 
+    // paired runs: the whole event sequence is fixed by the event ID alone,
+    // independent of thread scheduling and of what happened in earlier events
+    if (fPairedSeed > 0) {
+        long seeds[3] = { fPairedSeed, anEvent->GetEventID() + 1, 0 };
+        G4Random::setTheSeeds(seeds);
+    }
+
     // using neutron file phase space
     if(fUseNeutronPhaseSpace) {
         // 7-d
@@ -192,10 +202,19 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
         mom.setRThetaPhi(1., val[2], phi);
         fParticleGun->SetParticleMomentumDirection(mom.unit());
         
+        // skip the air gap up to the first placed component
+        G4double weight = 1.;
+        if (fTransportMode > 0) {
+            G4double time = val[0];
+            weight = TransportToBoundary(pos, mom.unit(), val[1], time);
+            fParticleGun->SetParticlePosition(pos);
+            fParticleGun->SetParticleTime(time);
+        }
 
         // generate the vertex
         fParticleGun->GeneratePrimaryVertex(anEvent); // for first implementation
         //fGPS->GeneratePrimaryVertex(anEvent);
+        if (weight != 1.) anEvent->GetPrimaryVertex()->GetPrimary()->SetWeight(weight);
     }
     // protons incident on catcher
     else {
@@ -242,3 +261,52 @@ void PrimaryGeneratorAction::SetNeutronPhaseSpace(std::shared_ptr<THnSparseD> hi
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetTransportMode(G4String mode)
+{
+    if (mode == "weight")   fTransportMode = 1;
+    else                    fTransportMode = 0;
+    G4cout << " ---> Setting source transport mode: " << mode << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetPairedSeed(G4int seed)
+{
+    fPairedSeed = seed;
+    RootManager::GetInstance().SetUseGeant4Engine(seed > 0);
+    G4cout << " ---> Setting paired-run seed: " << seed << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double PrimaryGeneratorAction::TransportToBoundary(G4ThreeVector& pos, const G4ThreeVector& dir, 
+        G4double ekin, G4double& time)
+{
+    // stop 1 um short so the vertex stays in world air
+    G4double dist = fDetector->DistanceToFirstBoundary(pos, dir);
+    if (dist == kInfinity) return 1.;
+    dist -= 1.*um;
+    if (dist <= 0.) return 1.;
+
+    // macroscopic neutron cross section of the world material
+    G4HadronicProcessStore* store = G4HadronicProcessStore::Instance();
+    const G4ParticleDefinition* neutron = fParticleGun->GetParticleDefinition();
+    const G4Material* air = fDetector->GetWorldMaterial();
+    G4double sigma = store->GetElasticCrossSectionPerVolume(neutron, ekin, air)
+                   + store->GetInelasticCrossSectionPerVolume(neutron, ekin, air)
+                   + store->GetCaptureCrossSectionPerVolume(neutron, ekin, air);
+
+    // uncollided transmission carried as weight; neutrons that would have
+    // scattered in the air gap are not followed
+    G4double weight = std::exp(-sigma * dist);
+
+    G4double gamma = 1. + ekin / fNeutronMass;
+    G4double beta = std::sqrt(1. - 1. / (gamma * gamma));
+    time += dist / (beta * c_light);
+    pos += dist * dir;
+
+    return weight;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
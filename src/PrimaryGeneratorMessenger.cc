@@ -28,6 +28,25 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* gun
     fSetNeutronsCmd->SetGuidance("set neutrons emitted from catcher");
     fSetNeutronsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+    // move source neutrons through the air gap analytically
+    fSetTransportModeCmd = new G4UIcmdWithAString("/LDRS/gun/setTransportMode", this);
+    fSetTransportModeCmd->SetGuidance("transport source neutrons to the first placed component");
+    fSetTransportModeCmd->SetGuidance("  none   : start at the catcher (default)");
+    fSetTransportModeCmd->SetGuidance("  weight : uncollided air transmission applied as primary weight;");
+    fSetTransportModeCmd->SetGuidance("           neutrons scattered in the air gap are dropped, so only");
+    fSetTransportModeCmd->SetGuidance("           the uncollided component reaches the setup");
+    fSetTransportModeCmd->SetParameterName("mode", false);
+    fSetTransportModeCmd->SetCandidates("none weight");
+    fSetTransportModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+    // correlated sampling between sample-in and open-beam runs
+    fSetPairedSeedCmd = new G4UIcmdWithAnInteger("/LDRS/gun/setPairedSeed", this);
+    fSetPairedSeedCmd->SetGuidance("reseed every event from (seed, eventID) so that runs with the");
+    fSetPairedSeedCmd->SetGuidance("same seed share primaries and random streams (0 = off)");
+    fSetPairedSeedCmd->SetParameterName("seed", false);
+    fSetPairedSeedCmd->SetRange("seed>=0");
+    fSetPairedSeedCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -37,6 +56,8 @@ PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
     delete fDir;
     delete fSetProtonsCmd;
     delete fSetNeutronsCmd;
+    delete fSetTransportModeCmd;
+    delete fSetPairedSeedCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -50,6 +71,14 @@ void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newVa
     if(command == fSetNeutronsCmd) {
         fPrimaryGeneratorAction->SetNeutrons();
     }
+
+    if(command == fSetTransportModeCmd) {
+        fPrimaryGeneratorAction->SetTransportMode(newValue);
+    }
+
+    if(command == fSetPairedSeedCmd) {
+        fPrimaryGeneratorAction->SetPairedSeed(fSetPairedSeedCmd->GetNewIntValue(newValue));
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,218 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file RNtupleOutput.cc
+/// \brief Implementation of the RNtupleOutput class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "RNtupleOutput.hh"
+
+#include "NtupleBuffer.hh"
+
+#include "RVersion.h"
+
+// LDRS_HAVE_ROOTNTUPLE: set by CMake when ROOT::ROOTNTuple is found
+#if defined(LDRS_HAVE_ROOTNTUPLE) && ROOT_VERSION_CODE >= ROOT_VERSION(6, 34, 0)
+#define LDRS_RNTUPLE 1
+#include "TFile.h"
+#include <ROOT/REntry.hxx>
+#include <ROOT/RNTupleFillContext.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#include <ROOT/RNTupleParallelWriter.hxx>
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef LDRS_RNTUPLE
+
+namespace
+{
+// RNTuple left ROOT::Experimental in 6.36
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 36, 0)
+namespace RNT = ROOT;
+#else
+namespace RNT = ROOT::Experimental;
+#endif
+
+// shared: opened by the master, read by every thread during the run
+std::unique_ptr<TFile> gOutputFile;
+std::vector<std::unique_ptr<RNT::RNTupleParallelWriter>> gWriters;  // by ntuple id
+
+// one thread's writing end of an ntuple; per column exactly one of the
+// typed values is set
+struct Context
+{
+    std::shared_ptr<RNT::RNTupleFillContext> fContext;
+    std::unique_ptr<RNT::REntry> fEntry;
+    std::vector<std::shared_ptr<std::int32_t>> fInt;
+    std::vector<std::shared_ptr<float>> fFloat;
+    std::vector<std::shared_ptr<double>> fDouble;
+};
+// by ntuple id; a pointer, as G4ThreadLocal may be __thread
+G4ThreadLocal std::vector<Context>* tContexts = nullptr;
+}
+
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RNtupleOutput::IsAvailable()
+{
+#ifdef LDRS_RNTUPLE
+    return true;
+#else
+    return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RNtupleOutput::Open(const G4String& fileName, NtupleBuffer* const buffers[], G4int n)
+{
+#ifdef LDRS_RNTUPLE
+    Close();
+    gOutputFile.reset(TFile::Open(fileName.c_str(), "RECREATE"));
+    if (!gOutputFile || gOutputFile->IsZombie()) {
+        gOutputFile.reset();
+        G4Exception("RNtupleOutput::Open()", "RNtuple01", JustWarning, ("cannot open " + fileName).c_str());
+        return false;
+    }
+
+    gWriters.resize(n);
+    for (G4int id = 0; id < n; id++) {
+        if (!buffers[id]) continue;
+        auto model = RNT::RNTupleModel::Create();
+        for (const auto& column : buffers[id]->GetColumns()) {
+            switch (column.fType) {
+                case NtupleBuffer::kInt:
+                case NtupleBuffer::kCode:   model->MakeField<std::int32_t>(column.fName); break;
+                case NtupleBuffer::kFloat:  model->MakeField<float>(column.fName); break;
+                default:                    model->MakeField<double>(column.fName); break;
+            }
+        }
+        gWriters[id] = RNT::RNTupleParallelWriter::Append(std::move(model), buffers[id]->GetName(), *gOutputFile);
+    }
+    G4cout << " ---> RNTuple output: " << fileName << G4endl;
+    return true;
+#else
+    (void)fileName; (void)buffers; (void)n;
+    return false;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RNtupleOutput::Attach(NtupleBuffer* const buffers[], G4int n)
+{
+#ifdef LDRS_RNTUPLE
+    delete tContexts;
+    tContexts = new std::vector<Context>(n);
+    for (G4int id = 0; id < n && id < (G4int)gWriters.size(); id++) {
+        if (!buffers[id] || !gWriters[id]) continue;
+        Context& context = (*tContexts)[id];
+        context.fContext = gWriters[id]->CreateFillContext();
+        context.fEntry = context.fContext->CreateEntry();
+
+        // the field values are looked up once, not per row
+        const auto& columns = buffers[id]->GetColumns();
+        context.fInt.resize(columns.size());
+        context.fFloat.resize(columns.size());
+        context.fDouble.resize(columns.size());
+        for (std::size_t col = 0; col < columns.size(); col++) {
+            const auto& column = columns[col];
+            switch (column.fType) {
+                case NtupleBuffer::kInt:
+                case NtupleBuffer::kCode:   context.fInt[col] = context.fEntry->GetPtr<std::int32_t>(column.fName); break;
+                case NtupleBuffer::kFloat:  context.fFloat[col] = context.fEntry->GetPtr<float>(column.fName); break;
+                default:                    context.fDouble[col] = context.fEntry->GetPtr<double>(column.fName); break;
+            }
+        }
+        buffers[id]->SetRNtuple(true);
+    }
+#else
+    (void)buffers; (void)n;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RNtupleOutput::Fill(const NtupleBuffer& buffer)
+{
+#ifdef LDRS_RNTUPLE
+    if (!tContexts) return;
+    Context& context = (*tContexts)[buffer.GetNtupleId()];
+    if (!context.fContext) return;
+
+    G4int nColumns = buffer.GetNColumns();
+    for (std::size_t row = 0; row < buffer.GetNRows(); row++) {
+        for (G4int col = 0; col < nColumns; col++) {
+            G4double val = buffer.GetColumn(col)[row];
+            if (context.fInt[col]) *context.fInt[col] = (std::int32_t)val;
+            else if (context.fFloat[col]) *context.fFloat[col] = (float)val;
+            else *context.fDouble[col] = val;
+        }
+        context.fContext->Fill(*context.fEntry);
+    }
+#else
+    (void)buffer;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RNtupleOutput::Detach(NtupleBuffer* const buffers[], G4int n)
+{
+    for (G4int id = 0; id < n; id++) {
+        if (buffers[id]) buffers[id]->SetRNtuple(false);
+    }
+#ifdef LDRS_RNTUPLE
+    // a fill context commits its open cluster when it goes
+    delete tContexts;
+    tContexts = nullptr;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RNtupleOutput::Close()
+{
+#ifdef LDRS_RNTUPLE
+    // the writers commit the ntuples into the file when they go
+    gWriters.clear();
+    if (gOutputFile) {
+        gOutputFile->Close();
+        gOutputFile.reset();
+    }
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -2,10 +2,15 @@
 #include "G4Exception.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Threading.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
 
 // Thread-local storage definitions
 thread_local std::unique_ptr<THnSparseD> RootManager::fThreadLocalSparse = nullptr;
 thread_local std::unique_ptr<TRandom3> RootManager::fThreadLocalRandom = nullptr;
+thread_local std::vector<Double_t> RootManager::fThreadLocalCdf;
+thread_local std::vector<Long64_t> RootManager::fThreadLocalBins;
 
 RootManager::RootManager() 
     : fMasterSparse(nullptr), 
@@ -119,5 +124,45 @@ void RootManager::SampleEvent(Double_t* values) {
     }
     
     // Now sample without any locks - each thread has its own copy
-    fThreadLocalSparse->GetRandom(values);
+    if (!fUseGeant4Engine) {
+        fThreadLocalSparse->GetRandom(values);
+        return;
+    }
+
+    // same bin + uniform-within-bin scheme as THnBase::GetRandom, but driven
+    // by the Geant4 engine
+    if (fThreadLocalCdf.empty()) BuildThreadLocalCdf();
+    if (fThreadLocalCdf.empty()) {
+        G4Exception("RootManager::SampleEvent", "EmptyPhaseSpace",
+                   FatalException, "Phase space histogram has no filled bins");
+        return;
+    }
+    Double_t u = G4UniformRand();
+    std::size_t idx = std::upper_bound(fThreadLocalCdf.begin(), fThreadLocalCdf.end(), u) - fThreadLocalCdf.begin();
+    if (idx >= fThreadLocalBins.size()) idx = fThreadLocalBins.size() - 1;
+
+    Int_t ndim = fThreadLocalSparse->GetNdimensions();
+    std::vector<Int_t> coord(ndim);
+    fThreadLocalSparse->GetBinContent(fThreadLocalBins[idx], coord.data());
+    for (Int_t d = 0; d < ndim; d++) {
+        TAxis* axis = fThreadLocalSparse->GetAxis(d);
+        values[d] = axis->GetBinLowEdge(coord[d]) + axis->GetBinWidth(coord[d]) * G4UniformRand();
+    }
+}
+
+void RootManager::BuildThreadLocalCdf() {
+    Long64_t nbins = fThreadLocalSparse->GetNbins();
+    std::vector<Int_t> coord(fThreadLocalSparse->GetNdimensions());
+
+    fThreadLocalCdf.clear();
+    fThreadLocalBins.clear();
+    Double_t sum = 0.;
+    for (Long64_t i = 0; i < nbins; ++i) {
+        Double_t content = fThreadLocalSparse->GetBinContent(i, coord.data());
+        if (content <= 0.) continue;
+        sum += content;
+        fThreadLocalCdf.push_back(sum);
+        fThreadLocalBins.push_back(i);
+    }
+    for (auto& c : fThreadLocalCdf) c /= sum;
 }
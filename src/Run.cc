@@ -33,16 +33,25 @@
 #include "Run.hh"
 
 #include "DetectorConstruction.hh"
+#include "KillZones.hh"
 #include "HistoManager.hh"
 #include "PrimaryGeneratorAction.hh"
+#include "AllocTracker.hh"
 
 #include "G4HadronicProcess.hh"
 #include "G4HadronicProcessStore.hh"
+#include "G4IonTable.hh"
+#include "G4Isotope.hh"
 #include "G4Neutron.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4ParticleTable.hh"
 #include "G4ProcessTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
+#include <algorithm>
+#include <numeric>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 Run::Run(DetectorConstruction* det) : fDetector(det)
@@ -74,17 +83,10 @@ void Run::SetTargetXXX(G4bool flag)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::CountProcesses(G4VProcess* process)
+void Run::CountProcesses(const G4VProcess* process)
 {
     if (process == nullptr) return;
-    G4String procName = process->GetProcessName();
-    std::map<G4String, G4int>::iterator it = fProcCounter.find(procName);
-    if (it == fProcCounter.end()) {
-        fProcCounter[procName] = 1;
-    }
-    else {
-        fProcCounter[procName]++;
-    }
+    fProcCounter[process]++;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -98,36 +100,27 @@ void Run::SumTrack(G4double trackl)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::CountNuclearChannel(G4String name, G4double Q)
+void Run::CountNuclearChannel(const ChannelKey& key, G4double Q)
 {
-    std::map<G4String, NuclChannel>::iterator it = fNuclChannelMap.find(name);
-    if (it == fNuclChannelMap.end()) {
-        fNuclChannelMap[name] = NuclChannel(1, Q);
-    }
-    else {
-        NuclChannel& data = it->second;
-        data.fCount++;
-        data.fQ += Q;
-    }
+    NuclChannel& data = fNuclChannelMap[key];
+    data.fCount++;
+    data.fQ += Q;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::ParticleCount(G4String name, G4double Ekin)
+void Run::ParticleCount(G4int pdg, G4double Ekin)
 {
-    std::map<G4String, ParticleData>::iterator it = fParticleDataMap.find(name);
-    if (it == fParticleDataMap.end()) {
-        fParticleDataMap[name] = ParticleData(1, Ekin, Ekin, Ekin);
+    ParticleData& data = fParticleDataMap[pdg];
+    if (data.fCount == 0) {
+        data = ParticleData(1, Ekin, Ekin, Ekin);
     }
     else {
-        ParticleData& data = it->second;
         data.fCount++;
         data.fEmean += Ekin;
         // update min max
-        G4double emin = data.fEmin;
-        if (Ekin < emin) data.fEmin = Ekin;
-        G4double emax = data.fEmax;
-        if (Ekin > emax) data.fEmax = Ekin;
+        if (Ekin < data.fEmin) data.fEmin = Ekin;
+        if (Ekin > data.fEmax) data.fEmax = Ekin;
     }
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -155,8 +148,19 @@ void Run::CountGamma(G4int nGamma)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void Run::SetStackRules(const std::vector<G4String>& names)
+{
+    fStackRuleNames = names;
+    fStackKillCounter.assign(names.size(), 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void Run::Merge(const G4Run* run)
 {
+    // called on the worker thread, before its EndOfRunAction
+    AllocTracker::SetPhase(AllocTracker::kMerge);
+
     const Run* localRun = static_cast<const Run*>(run);
 
     // primary particle info
@@ -168,6 +172,7 @@ void Run::Merge(const G4Run* run)
     //
     fTotalCount += localRun->fTotalCount;
     fGammaCount += localRun->fGammaCount;
+    fNSpeciesOverflow += localRun->fNSpeciesOverflow;
     fSumTrack += localRun->fSumTrack;
     fSumTrack2 += localRun->fSumTrack2;
 
@@ -185,61 +190,214 @@ void Run::Merge(const G4Run* run)
     if (fNbGamma[1] > nbmin) fNbGamma[1] = nbmin;
     if (fNbGamma[2] < nbmax) fNbGamma[2] = nbmax;
 
-    // map: processes count
-    std::map<G4String, G4int>::const_iterator itp;
-    for (itp = localRun->fProcCounter.begin(); itp != localRun->fProcCounter.end(); ++itp) {
-        G4String procName = itp->first;
-        G4int localCount = itp->second;
-        if (fProcCounter.find(procName) == fProcCounter.end()) {
-            fProcCounter[procName] = localCount;
-        }
-        else {
-            fProcCounter[procName] += localCount;
+    // processes count
+    localRun->fProcCounter.ForEach([this](const G4VProcess* proc, G4int count) {
+        fProcCounter[proc] += count;
+    });
+
+    // nuclear channels
+    localRun->fNuclChannelMap.ForEach([this](const ChannelKey& key, const NuclChannel& localData) {
+        NuclChannel& data = fNuclChannelMap[key];
+        data.fCount += localData.fCount;
+        data.fQ += localData.fQ;
+    });
+
+    // particles count
+    localRun->fParticleDataMap.ForEach([this](G4int pdg, const ParticleData& localData) {
+        ParticleData& data = fParticleDataMap[pdg];
+        if (data.fCount == 0) {
+            data = localData;
+            return;
         }
+        data.fCount += localData.fCount;
+        data.fEmean += localData.fEmean;
+        if (localData.fEmin < data.fEmin) data.fEmin = localData.fEmin;
+        if (localData.fEmax > data.fEmax) data.fEmax = localData.fEmax;
+    });
+
+    // kill zone counts
+    if (fKillCounter.size() < localRun->fKillCounter.size()) fKillCounter.resize(localRun->fKillCounter.size(), 0);
+    for (std::size_t i = 0; i < localRun->fKillCounter.size(); i++) {
+        fKillCounter[i] += localRun->fKillCounter[i];
     }
+    for (G4int i = 0; i < kNCullKinds; i++) {
+        fCullCounter[i] += localRun->fCullCounter[i];
+    }
+    // every worker runs the same rules; the master has none of its own
+    if (fStackRuleNames.empty()) SetStackRules(localRun->fStackRuleNames);
+    for (std::size_t i = 0; i < localRun->fStackKillCounter.size() && i < fStackKillCounter.size(); i++) {
+        fStackKillCounter[i] += localRun->fStackKillCounter[i];
+    }
+    fNSplits += localRun->fNSplits;
+    fNCopies += localRun->fNCopies;
+    fNRouletteSurvived += localRun->fNRouletteSurvived;
+    fNRouletteKilled += localRun->fNRouletteKilled;
+
+    // step profile
+    fProfile.Merge(localRun->fProfile);
+    fVoxelMap.Merge(localRun->fVoxelMap);
+    fEventCost.Merge(localRun->fEventCost);
+    fWindowTally.Merge(localRun->fWindowTally);
+    fPixelImage.Merge(localRun->fPixelImage);
+    fImageCube.Merge(localRun->fImageCube);
+    fStreamBuffer.Merge(localRun->fStreamBuffer);
 
-    // map: nuclear channels
-    std::map<G4String, NuclChannel>::const_iterator itc;
-    for (itc = localRun->fNuclChannelMap.begin(); itc != localRun->fNuclChannelMap.end(); ++itc) {
-        G4String name = itc->first;
-        const NuclChannel& localData = itc->second;
-        if (fNuclChannelMap.find(name) == fNuclChannelMap.end()) {
-            fNuclChannelMap[name] = NuclChannel(localData.fCount, localData.fQ);
+    G4Run::Merge(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Run::EndOfRun(G4bool print)
+{
+    // tracks stopped in kill zones
+    //
+    static const char* killNames[kNKillKinds] = { "neutron", "gamma", "e-", "other" };
+    if (!fKillCounter.empty()) {
+        G4cout << "\n Tracks killed in kill zones:" << G4endl;
+        const KillZones* zones = fDetector->GetKillZones();
+        G4long byKind[kNKillKinds] = {0};
+        for (std::size_t zone = 0; zone * kNKillKinds < fKillCounter.size(); zone++) {
+            const G4long* counts = &fKillCounter[zone * kNKillKinds];
+            G4long total = std::accumulate(counts, counts + kNKillKinds, (G4long)0);
+            if (total == 0) continue;
+            G4cout << "  " << std::setw(3) << zone << " (" << zones->Describe(zone) << "): " << total << "  [";
+            const char* sep = "";
+            for (G4int k = 0; k < kNKillKinds; k++) {
+                byKind[k] += counts[k];
+                if (counts[k] == 0) continue;
+                G4cout << sep << killNames[k] << " " << counts[k];
+                sep = ", ";
+            }
+            G4cout << "]" << G4endl;
         }
-        else {
-            NuclChannel& data = fNuclChannelMap[name];
-            data.fCount += localData.fCount;
-            data.fQ += localData.fQ;
+        G4cout << "  by particle:";
+        for (G4int k = 0; k < kNKillKinds; k++) {
+            G4cout << "  " << killNames[k] << " " << byKind[k];
         }
+        G4cout << G4endl;
     }
+    fKillCounter.clear();
 
-    // map: particles count
-    std::map<G4String, ParticleData>::const_iterator itn;
-    for (itn = localRun->fParticleDataMap.begin(); itn != localRun->fParticleDataMap.end(); ++itn) {
-        G4String name = itn->first;
-        const ParticleData& localData = itn->second;
-        if (fParticleDataMap.find(name) == fParticleDataMap.end()) {
-            fParticleDataMap[name] =
-                ParticleData(localData.fCount, localData.fEmean, localData.fEmin, localData.fEmax);
+    // neutrals culled on their way out of the beamline
+    //
+    static const char* cullNames[kNCullKinds] = { "neutron", "gamma", "other" };
+    if (std::any_of(fCullCounter, fCullCounter + kNCullKinds, [](G4long n) { return n > 0; })) {
+        G4cout << "\n Neutrals culled (line missing the panels):" << G4endl;
+        for (G4int i = 0; i < kNCullKinds; i++) {
+            if (fCullCounter[i] == 0) continue;
+            G4cout << "  " << std::setw(13) << cullNames[i] << ": " << fCullCounter[i] << G4endl;
         }
-        else {
-            ParticleData& data = fParticleDataMap[name];
-            data.fCount += localData.fCount;
-            data.fEmean += localData.fEmean;
-            G4double emin = localData.fEmin;
-            if (emin < data.fEmin) data.fEmin = emin;
-            G4double emax = localData.fEmax;
-            if (emax > data.fEmax) data.fEmax = emax;
+    }
+    std::fill(fCullCounter, fCullCounter + kNCullKinds, 0);
+
+    // importance splitting and roulette
+    //
+    if (fNSplits > 0 || fNRouletteSurvived + fNRouletteKilled > 0) {
+        G4cout << "\n Importance biasing: " << fNSplits << " splits (" << fNCopies << " copies), "
+               << fNRouletteSurvived + fNRouletteKilled << " roulettes (" << fNRouletteKilled 
+               << " killed)" << G4endl;
+    }
+    fNSplits = fNCopies = fNRouletteSurvived = fNRouletteKilled = 0;
+
+    // secondaries killed by stacking rules
+    //
+    if (std::any_of(fStackKillCounter.begin(), fStackKillCounter.end(), [](G4long n) { return n > 0; })) {
+        G4cout << "\n Secondaries killed at stacking:" << G4endl;
+        for (std::size_t i = 0; i < fStackKillCounter.size(); i++) {
+            if (fStackKillCounter[i] == 0) continue;
+            G4cout << "  " << std::setw(30) << fStackRuleNames[i] << ": " << fStackKillCounter[i] << G4endl;
         }
     }
+    fStackKillCounter.assign(fStackKillCounter.size(), 0);
 
-    G4Run::Merge(run);
-}
+    // interaction analysis (first interaction of each primary)
+    //
+    if (fTotalCount > 0 || !fProcCounter.Empty()) {
+        G4int prec = 5, wid = prec + 2;
+        G4int dfprec = G4cout.precision(prec);
+
+        // frequency of processes, summed over the threads' process objects
+        //
+        std::map<G4String, G4int> procCount;
+        fProcCounter.ForEach([&procCount](const G4VProcess* proc, G4int count) {
+            procCount[proc->GetProcessName()] += count;
+        });
+        G4cout << "\n Process calls frequency:" << G4endl;
+        for (const auto& proc : procCount) {
+            G4cout << "\t" << proc.first << "= " << proc.second;
+        }
+        G4cout << G4endl;
+
+        // nuclear channel count
+        //
+        std::map<G4String, NuclChannel> channels;
+        fNuclChannelMap.ForEach([this, &channels](const ChannelKey& key, const NuclChannel& data) {
+            NuclChannel& channel = channels[ChannelName(key)];
+            channel.fCount += data.fCount;
+            channel.fQ += data.fQ;
+        });
+        G4cout << "\n List of nuclear reactions: \n" << G4endl;
+        for (const auto& channel : channels) {
+            G4int count = channel.second.fCount;
+            G4double Q = channel.second.fQ / count;
+            if (print)
+                G4cout << "  " << std::setw(60) << channel.first << ": " << std::setw(7) << count
+                    << "   Q = " << std::setw(wid) << G4BestUnit(Q, "Energy") << G4endl;
+        }
+        if (fNSpeciesOverflow > 0) {
+            G4cout << "\n   --> WARNING: " << fNSpeciesOverflow << " reaction(s) with more than "
+                << kMaxSpecies << " product species, listed with the first " << kMaxSpecies
+                << " only (lowest PDG codes)" << G4endl;
+        }
+
+        // Gamma count
+        //
+        if (print && (fGammaCount > 0)) {
+            G4cout << "\n"
+                << std::setw(58) << "number of gamma or e- (ic): N = " << fNbGamma[1] << " --> "
+                << fNbGamma[2] << G4endl;
+        }
+
+        if (print && fTargetXXX) {
+            G4cout << "\n   --> NOTE: XXXX because neutronHP is unable to return target nucleus" << G4endl;
+        }
+
+        // particles count
+        //
+        std::map<G4String, ParticleData> particles;
+        fParticleDataMap.ForEach([this, &particles](G4int pdg, const ParticleData& data) {
+            particles[ParticleName(pdg)] = data;
+        });
+        G4cout << "\n List of generated particles:" << G4endl;
+        for (const auto& particle : particles) {
+            const ParticleData& data = particle.second;
+            G4double eMean = data.fEmean / data.fCount;
+            if (print)
+                G4cout << "  " << std::setw(13) << particle.first << ": " << std::setw(7) << data.fCount
+                    << "  Emean = " << std::setw(wid) << G4BestUnit(eMean, "Energy") << "\t( "
+                    << G4BestUnit(data.fEmin, "Energy") << " --> " << G4BestUnit(data.fEmax, "Energy") << ")"
+                    << G4endl;
+        }
+
+        // energy momentum balance
+        //
+        if (fTotalCount > 1) {
+            G4double Pbmean = fPbalance[0] / fTotalCount;
+            G4cout << "\n   Momentum balance: Pmean = " << std::setw(wid) << G4BestUnit(Pbmean, "Energy")
+                << "\t( " << G4BestUnit(fPbalance[1], "Energy") << " --> "
+                << G4BestUnit(fPbalance[2], "Energy") << ") \n"
+                << G4endl;
+        }
+
+        fProcCounter.Clear();
+        fNuclChannelMap.Clear();
+        fParticleDataMap.Clear();
+
+        // restore default format
+        G4cout.precision(dfprec);
+    }
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void Run::EndOfRun(G4bool print)
-{
     // G4int prec = 5, wid = prec + 2;
     // G4int dfprec = G4cout.precision(prec);
 
@@ -335,73 +493,40 @@ void Run::EndOfRun(G4bool print)
     //     G4cout << " not available" << G4endl;
     // }
 
-    // // nuclear channel count
-    // //
-    // G4cout << "\n List of nuclear reactions: \n" << G4endl;
-    // std::map<G4String, NuclChannel>::iterator ic;
-    // for (ic = fNuclChannelMap.begin(); ic != fNuclChannelMap.end(); ic++) {
-    //     G4String name = ic->first;
-    //     NuclChannel data = ic->second;
-    //     G4int count = data.fCount;
-    //     G4double Q = data.fQ / count;
-    //     if (print)
-    //         G4cout << "  " << std::setw(60) << name << ": " << std::setw(7) << count
-    //             << "   Q = " << std::setw(wid) << G4BestUnit(Q, "Energy") << G4endl;
-    // }
-
-    // // Gamma count
-    // //
-    // if (print && (fGammaCount > 0)) {
-    //     G4cout << "\n"
-    //         << std::setw(58) << "number of gamma or e- (ic): N = " << fNbGamma[1] << " --> "
-    //         << fNbGamma[2] << G4endl;
-    // }
-
-    // if (print && fTargetXXX) {
-    //     G4cout << "\n   --> NOTE: XXXX because neutronHP is unable to return target nucleus" << G4endl;
-    // }
-
-    // // particles count
-    // //
-    // G4cout << "\n List of generated particles:" << G4endl;
-
-    // std::map<G4String, ParticleData>::iterator itn;
-    // for (itn = fParticleDataMap.begin(); itn != fParticleDataMap.end(); itn++) {
-    //     G4String name = itn->first;
-    //     ParticleData data = itn->second;
-    //     G4int count = data.fCount;
-    //     G4double eMean = data.fEmean / count;
-    //     G4double eMin = data.fEmin;
-    //     G4double eMax = data.fEmax;
-    //     if (print)
-    //         G4cout << "  " << std::setw(13) << name << ": " << std::setw(7) << count
-    //             << "  Emean = " << std::setw(wid) << G4BestUnit(eMean, "Energy") << "\t( "
-    //             << G4BestUnit(eMin, "Energy") << " --> " << G4BestUnit(eMax, "Energy") << ")"
-    //             << G4endl;
-    // }
+    // G4cout.precision(dfprec);
+}
 
-    // // energy momentum balance
-    // //
-    // if (fTotalCount > 1) {
-    //     G4double Pbmean = fPbalance[0] / fTotalCount;
-    //     G4cout << "\n   Momentum balance: Pmean = " << std::setw(wid) << G4BestUnit(Pbmean, "Energy")
-    //         << "\t( " << G4BestUnit(fPbalance[1], "Energy") << " --> "
-    //         << G4BestUnit(fPbalance[2], "Energy") << ") \n"
-    //         << G4endl;
-    // }
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-    // // normalize histograms
-    // ////G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
-    // ////G4double factor = 1./numberOfEvent;
-    // ////analysisManager->ScaleH1(3,factor);
+G4String Run::ParticleName(G4int pdg) const
+{
+    G4ParticleDefinition* particle = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+    if (!particle && pdg > 1000000000) particle = G4IonTable::GetIonTable()->GetIon(pdg);
+    return particle ? particle->GetParticleName() : G4String(std::to_string(pdg));
+}
 
-    // // remove all contents in fProcCounter, fCount
-    // fProcCounter.clear();
-    // fNuclChannelMap.clear();
-    // fParticleDataMap.clear();
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-    // // restore default format
-    // G4cout.precision(dfprec);
+G4String Run::ChannelName(const ChannelKey& key) const
+{
+    G4String name = ParticleName(key.fProjectile) + " + ";
+    const G4IsotopeTable* isotopes = G4Isotope::GetIsotopeTable();
+    if (key.fTarget > 0 && key.fTarget <= (G4int)isotopes->size())
+        name += (*isotopes)[key.fTarget - 1]->GetName();
+    else
+        name += "XXXX";
+    name += " --> ";
+
+    for (G4int i = 0; i < key.fNSpecies; i++) {
+        if (i > 0) name += " + ";
+        if (key.fPDG[i] == 22)
+            name += "N gamma or e-";
+        else if (key.fCount[i] > 1)
+            name += std::to_string(key.fCount[i]) + " " + ParticleName(key.fPDG[i]);
+        else
+            name += ParticleName(key.fPDG[i]);
+    }
+    return name;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -37,8 +37,22 @@
 #include "PrimaryGeneratorAction.hh"
 #include "Run.hh"
 #include "RunMessenger.hh"
+#include "SteppingAction.hh"
+#include "TrackingAction.hh"
+#include "StackingAction.hh"
+#include "ScorerRegistry.hh"
+#include "KillZones.hh"
+#include "ImportanceBiasing.hh"
+#include "WeightWindows.hh"
+#include "Digitizer.hh"
+#include "ImageEstimator.hh"
+#include "AllocTracker.hh"
+#include "ListModeWriter.hh"
 
 #include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 #include "Randomize.hh"
@@ -59,6 +73,8 @@ RunAction::RunAction(DetectorConstruction* det, PrimaryGeneratorAction* prim)
 {
     fHistoManager = new HistoManager();
     fRunMessenger = new RunMessenger(this);
+    fHitStream = new HitStream();
+    fListMode = new ListModeWriter();
 
     //if(isMaster) {
     //    TFile* f = TFile::Open("root_files/G4Li_3mm_1e9_phase.root", "READ");
@@ -80,6 +96,8 @@ RunAction::~RunAction()
 {
     delete fHistoManager;
     delete fRunMessenger;
+    delete fHitStream;
+    delete fListMode;
 
     if(fProgBar)
         delete fProgBar;
@@ -101,10 +119,87 @@ G4Run* RunAction::GenerateRun()
 
 void RunAction::BeginOfRunAction(const G4Run* run)
 {
+    AllocTracker::SetPhase(AllocTracker::kInit);
+
     // show Rndm status
     if (isMaster) {
         G4Random::showEngineStatus();
         G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+
+        // volumes are placed after /run/initialize, so the scorer table is
+        // built here, before any worker starts stepping
+        fDetector->GetScorers()->Resolve();
+        fDetector->GetKillZones()->Resolve();
+        fDetector->GetBiasing()->Resolve();
+        fDetector->GetWeightWindows()->Resolve();
+        fDetector->GetDigitizer()->Resolve();
+        fDetector->GetImageEstimator()->Resolve();
+        AllocTracker::BeginRun();
+    }
+
+    // step and time density maps, over the world unless a box was given
+    if (fVoxelMapping) {
+        G4ThreeVector lo = fVoxelLo, hi = fVoxelHi;
+        if (lo == hi) fDetector->GetWorld()->GetLogicalVolume()->GetSolid()->BoundingLimits(lo, hi);
+        fRun->GetVoxelMap()->Configure(fVoxelN[0], fVoxelN[1], fVoxelN[2], lo, hi, 
+                                       fVoxelSplit, fProfileSampling);
+    }
+
+    // per-event cost; the engine status is stored in each G4Event so that
+    // the slowest ones can be replayed
+    if (fEventCostOn) {
+        fRun->GetEventCost()->SetNSlowest(fNSlowEvents);
+        if (fPrimary) fRun->GetEventCost()->SetPairedSeed(fPrimary->GetPairedSeed());
+        G4RunManager::GetRunManager()->StoreRandomNumberStatusToG4Event(1);
+    }
+    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
+    for (G4int id : {HistoManager::kEventTime, HistoManager::kEventSteps, 
+                     HistoManager::kEventTracks, HistoManager::kEventSecondaries}) {
+        analysis->SetH1Activation(id, fEventCostOn);
+    }
+    if (fTracking) fTracking->SetEventCost(GetEventCost());
+
+    // pixelated panel image, and its estimates on the same pixels (or the
+    // estimator grid of a monolithic panel)
+    G4int nPixels = fDetector->GetPanelPixels();
+    G4double half = fDetector->GetDetectorPanelXY() / 2.;
+    if (nPixels > 0) {
+        analysis->SetH2(HistoManager::kPanelImage, nPixels, -half / mm, half / mm, nPixels, -half / mm, half / mm);
+    }
+    analysis->SetH2Activation(HistoManager::kPanelImage, nPixels > 0);
+    ImageEstimator* estimator = fDetector->GetImageEstimator();
+    G4int nImage = estimator->IsActive() ? estimator->GetNPixels() : nPixels;
+    if (nImage > 0) fRun->GetPixelImage()->Configure(nImage, half);
+    for (G4int id : {HistoManager::kPanelImageNEE, HistoManager::kPanelImageTLE}) {
+        G4bool on = (id == HistoManager::kPanelImageNEE) ? estimator->IsNextEvent() : estimator->IsTrackLength();
+        if (on) analysis->SetH2(id, nImage, -half / mm, half / mm, nImage, -half / mm, half / mm);
+        analysis->SetH2Activation(id, on);
+    }
+
+    // time-of-flight resolved image, filled from the panel hits
+    if (fImageCubeOn) {
+        fRun->GetImageCube()->Configure(fCubeN[0], fCubeN[1], fCubeN[2], fCubeXYLo, fCubeXYHi,
+                                        fCubeXYLo, fCubeXYHi, fCubeTLo, fCubeTHi, fCubeWeighted);
+    }
+
+    // beam-time ordered hit stream
+    fRun->GetStreamBuffer()->Configure(*fHitStream);
+
+    // weight-window pilot estimator
+    WeightWindows* windows = fDetector->GetWeightWindows();
+    fRun->GetWindowTally()->Configure(windows->GetNCells(), windows->IsPilot());
+
+    if (fStepping) {
+        fListMode->Open(run->GetRunID(), nPixels);
+        fRun->SetListModeWriter(fListMode->IsOpen() ? fListMode : nullptr);
+
+        fStepping->SetChannelAnalysis(fChannelAnalysis);
+        fRun->GetProfile()->SetSampling(fProfileSampling);
+        fStepping->SetProfile(fProfiling ? fRun->GetProfile() : nullptr);
+        fStepping->SetVoxelMap(fVoxelMapping ? fRun->GetVoxelMap() : nullptr);
+        fStepping->SetWindowTally(GetWindowTally());
+        fStepping->SetEstimatorImage(estimator->IsActive() ? fRun->GetPixelImage() : nullptr);
+        fStepping->SelectPipeline();
     }
 
     // keep run condition
@@ -113,6 +208,8 @@ void RunAction::BeginOfRunAction(const G4Run* run)
         G4double energy = fPrimary->GetParticleGun()->GetParticleEnergy();
         fRun->SetPrimary(particle, energy);
     }
+    // kills are counted by rule index, the names only go to the summary
+    if (fStacking) fRun->SetStackRules(fStacking->GetRuleNames());
 
     // histograms
     //
@@ -120,6 +217,7 @@ void RunAction::BeginOfRunAction(const G4Run* run)
     if (analysisManager->IsActive()) {
         analysisManager->OpenFile();
     }
+    fHistoManager->BeginRun(isMaster);
 
     ProgressBar::gEvtNb.store(0, std::memory_order_relaxed);
     if(fProgBar)
@@ -132,6 +230,7 @@ void RunAction::BeginOfRunAction(const G4Run* run)
 
 void RunAction::EndOfRunAction(const G4Run*)
 {
+    AllocTracker::SetPhase(AllocTracker::kMerge);
 
     if (isMaster) {
         // volumes
@@ -146,17 +245,69 @@ void RunAction::EndOfRunAction(const G4Run*)
         
         // run info
         fRun->EndOfRun(fPrint);
+        if (fProfiling) fRun->GetProfile()->Report(fProfileFile);
+        if (fVoxelMapping) fRun->GetVoxelMap()->Write(fVoxelFile);
+        if (fEventCostOn) fRun->GetEventCost()->Write(fSlowEventFile);
+        if (fDetector->GetPanelPixels() > 0) fRun->GetPixelImage()->FillH2(HistoManager::kPanelImage);
+        ImageEstimator* estimator = fDetector->GetImageEstimator();
+        if (estimator->IsNextEvent()) fRun->GetPixelImage()->FillH2(HistoManager::kPanelImageNEE, PixelImage::kNextEvent);
+        if (estimator->IsTrackLength()) fRun->GetPixelImage()->FillH2(HistoManager::kPanelImageTLE, PixelImage::kTrackLength);
+        if (fImageCubeOn) fRun->GetImageCube()->Write(fCubeFile, fFlightPath);
+        fHitStream->Process(*fRun->GetStreamBuffer());
+        if (fDetector->GetWeightWindows()->IsPilot()) {
+            fDetector->GetWeightWindows()->Update(*fRun->GetWindowTally(), fRun->GetNumberOfEvent());
+        }
+        AllocTracker::Report(fRun->GetNumberOfEvent());
         
         // show Rndm status
         G4Random::showEngineStatus();
     }
 
+    fListMode->Close();
+
     // save histograms
     G4AnalysisManager* analysisManager = G4AnalysisManager::Instance();
     if (analysisManager->IsActive()) {
+        HistoManager::FlushBuffers();
         analysisManager->Write();
         analysisManager->CloseFile();
     }
+    fHistoManager->EndRun(isMaster);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventCost* RunAction::GetEventCost()
+{
+    return (fEventCostOn && fRun) ? fRun->GetEventCost() : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WeightWindows::Tally* RunAction::GetWindowTally()
+{
+    return (fRun && fRun->GetWindowTally()->IsActive()) ? fRun->GetWindowTally() : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HitStream::Buffer* RunAction::GetStreamBuffer()
+{
+    return (fRun && fRun->GetStreamBuffer()->IsActive()) ? fRun->GetStreamBuffer() : nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::SetNtupleMerging(G4bool val)
+{
+    fHistoManager->SetNtupleMerging(val);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::SetNtupleBackend(const G4String& val)
+{
+    fHistoManager->SetBackend(val == "rntuple" ? HistoManager::kRNTuple : HistoManager::kTTree);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -35,7 +35,14 @@
 #include "RunAction.hh"
 
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcommand.hh"
 #include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -48,6 +55,157 @@ RunMessenger::RunMessenger(RunAction* run) : fRun(run)
   fPrintCmd->SetGuidance("print list of nuclear reactions");
   fPrintCmd->SetParameterName("print", false);
   fPrintCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fLDRSRunDir = new G4UIdirectory("/LDRS/run/");
+  fLDRSRunDir->SetGuidance("run commands");
+
+  fChannelAnalysisCmd = new G4UIcmdWithABool("/LDRS/run/setChannelAnalysis", this);
+  fChannelAnalysisCmd->SetGuidance("count processes, nuclear channels and secondaries");
+  fChannelAnalysisCmd->SetGuidance("at the first interaction of each primary");
+  fChannelAnalysisCmd->SetParameterName("analysis", false);
+  fChannelAnalysisCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fProfilingCmd = new G4UIcmdWithABool("/LDRS/run/setProfiling", this);
+  fProfilingCmd->SetGuidance("profile steps, tracks and sampled wall time");
+  fProfilingCmd->SetGuidance("per (logical volume, particle, process)");
+  fProfilingCmd->SetParameterName("profile", false);
+  fProfilingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fProfileSamplingCmd = new G4UIcmdWithAnInteger("/LDRS/run/setProfileSampling", this);
+  fProfileSamplingCmd->SetGuidance("time one step in every N");
+  fProfileSamplingCmd->SetParameterName("N", false);
+  fProfileSamplingCmd->SetRange("N>0");
+  fProfileSamplingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fProfileFileCmd = new G4UIcmdWithAString("/LDRS/run/setProfileFile", this);
+  fProfileFileCmd->SetGuidance("CSV file for the step profile");
+  fProfileFileCmd->SetParameterName("file", false);
+  fProfileFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fVoxelMapCmd = new G4UIcmdWithABool("/LDRS/run/setVoxelMap", this);
+  fVoxelMapCmd->SetGuidance("fill 3-D maps of steps and sampled wall time");
+  fVoxelMapCmd->SetGuidance("(time sampling period from setProfileSampling)");
+  fVoxelMapCmd->SetParameterName("map", false);
+  fVoxelMapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fVoxelGridCmd = new G4UIcommand("/LDRS/run/setVoxelGrid", this);
+  fVoxelGridCmd->SetGuidance("number of voxels along x, y and z");
+  for (auto name : {"nx", "ny", "nz"}) {
+    auto prm = new G4UIparameter(name, 'i', false);
+    prm->SetParameterRange(G4String(name) + ">0");
+    fVoxelGridCmd->SetParameter(prm);
+  }
+  fVoxelGridCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fVoxelBoxCmd = new G4UIcommand("/LDRS/run/setVoxelBox", this);
+  fVoxelBoxCmd->SetGuidance("world-frame box covered by the voxel map (default: the world)");
+  fVoxelBoxCmd->SetGuidance("[usage] /LDRS/run/setVoxelBox xlo ylo zlo xhi yhi zhi unit");
+  for (auto name : {"xlo", "ylo", "zlo", "xhi", "yhi", "zhi"}) {
+    auto prm = new G4UIparameter(name, 'd', false);
+    fVoxelBoxCmd->SetParameter(prm);
+  }
+  auto unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultUnit("mm");
+  fVoxelBoxCmd->SetParameter(unitPrm);
+  fVoxelBoxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fVoxelSplitCmd = new G4UIcmdWithABool("/LDRS/run/setVoxelSplit", this);
+  fVoxelSplitCmd->SetGuidance("separate maps for n, gamma, e+-, p and other particles");
+  fVoxelSplitCmd->SetParameterName("split", false);
+  fVoxelSplitCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fVoxelFileCmd = new G4UIcmdWithAString("/LDRS/run/setVoxelFile", this);
+  fVoxelFileCmd->SetGuidance("ROOT file for the voxel maps");
+  fVoxelFileCmd->SetParameterName("file", false);
+  fVoxelFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEventCostCmd = new G4UIcmdWithABool("/LDRS/run/setEventCost", this);
+  fEventCostCmd->SetGuidance("histogram per-event time, steps, tracks and secondaries");
+  fEventCostCmd->SetGuidance("and dump the slowest events with their random status");
+  fEventCostCmd->SetParameterName("cost", false);
+  fEventCostCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSlowEventsCmd = new G4UIcmdWithAnInteger("/LDRS/run/setSlowEvents", this);
+  fSlowEventsCmd->SetGuidance("number of slowest events kept per thread");
+  fSlowEventsCmd->SetParameterName("K", false);
+  fSlowEventsCmd->SetRange("K>=0");
+  fSlowEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSlowEventFileCmd = new G4UIcmdWithAString("/LDRS/run/setSlowEventFile", this);
+  fSlowEventFileCmd->SetGuidance("text file for the slowest events");
+  fSlowEventFileCmd->SetParameterName("file", false);
+  fSlowEventFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fImageCubeCmd = new G4UIcmdWithABool("/LDRS/run/setImageCube", this);
+  fImageCubeCmd->SetGuidance("accumulate an (x, y, time-of-flight) cube of panel hits");
+  fImageCubeCmd->SetParameterName("cube", false);
+  fImageCubeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCubeBinsCmd = new G4UIcommand("/LDRS/run/setCubeBins", this);
+  fCubeBinsCmd->SetGuidance("number of cube bins along x, y and time of flight");
+  for (auto name : {"nx", "ny", "nt"}) {
+    auto prm = new G4UIparameter(name, 'i', false);
+    prm->SetParameterRange(G4String(name) + ">0");
+    fCubeBinsCmd->SetParameter(prm);
+  }
+  fCubeBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCubeXYCmd = new G4UIcommand("/LDRS/run/setCubeXY", this);
+  fCubeXYCmd->SetGuidance("world-frame x and y range of the cube");
+  fCubeXYCmd->SetGuidance("[usage] /LDRS/run/setCubeXY lo hi unit");
+  for (auto name : {"lo", "hi"}) {
+    fCubeXYCmd->SetParameter(new G4UIparameter(name, 'd', false));
+  }
+  auto xyUnitPrm = new G4UIparameter("unit", 's', true);
+  xyUnitPrm->SetDefaultUnit("mm");
+  fCubeXYCmd->SetParameter(xyUnitPrm);
+  fCubeXYCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCubeTimeCmd = new G4UIcommand("/LDRS/run/setCubeTime", this);
+  fCubeTimeCmd->SetGuidance("time-of-flight range of the cube");
+  fCubeTimeCmd->SetGuidance("[usage] /LDRS/run/setCubeTime lo hi unit");
+  for (auto name : {"lo", "hi"}) {
+    fCubeTimeCmd->SetParameter(new G4UIparameter(name, 'd', false));
+  }
+  auto tUnitPrm = new G4UIparameter("unit", 's', true);
+  tUnitPrm->SetDefaultUnit("ns");
+  fCubeTimeCmd->SetParameter(tUnitPrm);
+  fCubeTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCubeWeightedCmd = new G4UIcmdWithABool("/LDRS/run/setCubeWeighted", this);
+  fCubeWeightedCmd->SetGuidance("fill the cube with the hit weights (false: counts)");
+  fCubeWeightedCmd->SetParameterName("weighted", false);
+  fCubeWeightedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fFlightPathCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/run/setFlightPath", this);
+  fFlightPathCmd->SetGuidance("source-to-panel flight path; > 0 also writes the cube");
+  fFlightPathCmd->SetGuidance("with a neutron energy axis");
+  fFlightPathCmd->SetParameterName("L", false);
+  fFlightPathCmd->SetRange("L>=0.");
+  fFlightPathCmd->SetUnitCategory("Length");
+  fFlightPathCmd->SetDefaultUnit("m");
+  fFlightPathCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCubeFileCmd = new G4UIcmdWithAString("/LDRS/run/setCubeFile", this);
+  fCubeFileCmd->SetGuidance("ROOT file for the image cube");
+  fCubeFileCmd->SetParameterName("file", false);
+  fCubeFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNtupleMergingCmd = new G4UIcmdWithABool("/LDRS/run/setNtupleMerging", this);
+  fNtupleMergingCmd->SetGuidance("true: worker ntuple rows go through the master's file (default)");
+  fNtupleMergingCmd->SetGuidance("false: one file per worker, <file>_t<thread>.root, joined offline by ldrs_merge");
+  fNtupleMergingCmd->SetParameterName("merge", false);
+  fNtupleMergingCmd->AvailableForStates(G4State_PreInit);
+  // applied by the master; workers read it when they book
+  fNtupleMergingCmd->SetToBeBroadcasted(false);
+
+  fNtupleBackendCmd = new G4UIcmdWithAString("/LDRS/run/setNtupleBackend", this);
+  fNtupleBackendCmd->SetGuidance("ttree: double columns through the analysis manager (default)");
+  fNtupleBackendCmd->SetGuidance("rntuple: typed fields in <file>_rnt.root, one writer per thread;");
+  fNtupleBackendCmd->SetGuidance("read them with ntuple_compat.C");
+  fNtupleBackendCmd->SetParameterName("backend", false);
+  fNtupleBackendCmd->SetCandidates("ttree rntuple");
+  fNtupleBackendCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -56,6 +214,28 @@ RunMessenger::~RunMessenger()
 {
   delete fPrintCmd;
   delete fRunDir;
+  delete fChannelAnalysisCmd;
+  delete fProfilingCmd;
+  delete fProfileSamplingCmd;
+  delete fProfileFileCmd;
+  delete fVoxelMapCmd;
+  delete fVoxelGridCmd;
+  delete fVoxelBoxCmd;
+  delete fVoxelSplitCmd;
+  delete fVoxelFileCmd;
+  delete fEventCostCmd;
+  delete fSlowEventsCmd;
+  delete fSlowEventFileCmd;
+  delete fImageCubeCmd;
+  delete fCubeBinsCmd;
+  delete fCubeXYCmd;
+  delete fCubeTimeCmd;
+  delete fCubeWeightedCmd;
+  delete fFlightPathCmd;
+  delete fCubeFileCmd;
+  delete fNtupleMergingCmd;
+  delete fNtupleBackendCmd;
+  delete fLDRSRunDir;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -65,6 +245,83 @@ void RunMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
   if (command == fPrintCmd) {
     fRun->SetPrintFlag(fPrintCmd->GetNewBoolValue(newValue));
   }
+  if (command == fChannelAnalysisCmd) {
+    fRun->SetChannelAnalysis(fChannelAnalysisCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fProfilingCmd) {
+    fRun->SetProfiling(fProfilingCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fProfileSamplingCmd) {
+    fRun->SetProfileSampling(fProfileSamplingCmd->GetNewIntValue(newValue));
+  }
+  if (command == fProfileFileCmd) {
+    fRun->SetProfileFile(newValue);
+  }
+  if (command == fVoxelMapCmd) {
+    fRun->SetVoxelMapping(fVoxelMapCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fVoxelGridCmd) {
+    G4int nx, ny, nz;
+    std::istringstream is(newValue);
+    is >> nx >> ny >> nz;
+    fRun->SetVoxelGrid(nx, ny, nz);
+  }
+  if (command == fVoxelBoxCmd) {
+    G4double xlo, ylo, zlo, xhi, yhi, zhi;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> xlo >> ylo >> zlo >> xhi >> yhi >> zhi >> unit;
+    G4double u = G4UIcommand::ValueOf(unit);
+    fRun->SetVoxelBox(G4ThreeVector(xlo, ylo, zlo) * u, G4ThreeVector(xhi, yhi, zhi) * u);
+  }
+  if (command == fVoxelSplitCmd) {
+    fRun->SetVoxelSplit(fVoxelSplitCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fVoxelFileCmd) {
+    fRun->SetVoxelFile(newValue);
+  }
+  if (command == fEventCostCmd) {
+    fRun->SetEventCost(fEventCostCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fSlowEventsCmd) {
+    fRun->SetNSlowEvents(fSlowEventsCmd->GetNewIntValue(newValue));
+  }
+  if (command == fSlowEventFileCmd) {
+    fRun->SetSlowEventFile(newValue);
+  }
+  if (command == fImageCubeCmd) {
+    fRun->SetImageCube(fImageCubeCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fCubeBinsCmd) {
+    G4int nx, ny, nt;
+    std::istringstream is(newValue);
+    is >> nx >> ny >> nt;
+    fRun->SetCubeBins(nx, ny, nt);
+  }
+  if (command == fCubeXYCmd || command == fCubeTimeCmd) {
+    G4double lo, hi;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> lo >> hi >> unit;
+    G4double u = G4UIcommand::ValueOf(unit);
+    if (command == fCubeXYCmd) fRun->SetCubeXY(lo * u, hi * u);
+    else fRun->SetCubeTime(lo * u, hi * u);
+  }
+  if (command == fCubeWeightedCmd) {
+    fRun->SetCubeWeighted(fCubeWeightedCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fFlightPathCmd) {
+    fRun->SetFlightPath(fFlightPathCmd->GetNewDoubleValue(newValue));
+  }
+  if (command == fCubeFileCmd) {
+    fRun->SetCubeFile(newValue);
+  }
+  if (command == fNtupleMergingCmd) {
+    fRun->SetNtupleMerging(fNtupleMergingCmd->GetNewBoolValue(newValue));
+  }
+  if (command == fNtupleBackendCmd) {
+    fRun->SetNtupleBackend(newValue);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
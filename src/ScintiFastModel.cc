@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScintiFastModel.cc
+/// \brief Implementation of the ScintiFastModel class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScintiFastModel.hh"
+
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4Electron.hh"
+#include "G4Proton.hh"
+#include "G4Region.hh"
+#include "G4Track.hh"
+#include "G4VSolid.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScintiFastModel::ScintiFastModel(const G4String& name, G4Region* envelope)
+    : G4VFastSimulationModel(name, envelope)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScintiFastModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+    // positrons are left alone: their annihilation photons can escape
+    return &particle == G4Electron::Definition() || &particle == G4Proton::Definition()
+        || (particle.GetParticleType() == "nucleus" && particle.GetPDGCharge() > 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScintiFastModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+    const G4Track* track = fastTrack.GetPrimaryTrack();
+    G4double range = fCalculator.GetRangeFromRestricteDEDX(track->GetKineticEnergy(),
+            track->GetParticleDefinition(), track->GetMaterial(), fastTrack.GetEnvelope());
+    // isotropic safety: scattering can turn the track towards any face
+    G4double safety = fastTrack.GetEnvelopeSolid()->DistanceToOut(fastTrack.GetPrimaryTrackLocalPosition());
+    return range < safety;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScintiFastModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+    fastStep.ProposeTotalEnergyDeposited(fastTrack.GetPrimaryTrack()->GetKineticEnergy());
+    fastStep.KillPrimaryTrack();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
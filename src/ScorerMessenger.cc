@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScorerMessenger.cc
+/// \brief Implementation of the ScorerMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScorerMessenger.hh"
+
+#include "ScorerRegistry.hh"
+
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScorerMessenger::ScorerMessenger(ScorerRegistry* reg) : fRegistry(reg)
+{
+    fDir = new G4UIdirectory("/LDRS/score/");
+    fDir->SetGuidance("boundary-crossing scorer commands");
+
+    fAddCrossingCmd = new G4UIcommand("/LDRS/score/addCrossing", this);
+    fAddCrossingCmd->SetGuidance("score particles stepping from one volume into another");
+    fAddCrossingCmd->SetGuidance("volumes are physical or logical volume names, or World;");
+    fAddCrossingCmd->SetGuidance("all placed copies match. Resolved at the next beamOn.");
+    auto fromPrm = new G4UIparameter("from", 's', false);
+    fAddCrossingCmd->SetParameter(fromPrm);
+    auto toPrm = new G4UIparameter("to", 's', false);
+    fAddCrossingCmd->SetParameter(toPrm);
+    auto ntuplePrm = new G4UIparameter("ntuple", 's', true);
+    ntuplePrm->SetDefaultValue("crossing");
+    ntuplePrm->SetParameterCandidates("tree shield crossing");
+    fAddCrossingCmd->SetParameter(ntuplePrm);
+    fAddCrossingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fClearCmd = new G4UIcmdWithoutParameter("/LDRS/score/clear", this);
+    fClearCmd->SetGuidance("remove all scorers, including the default catcher and shielding ones");
+    fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fListCmd = new G4UIcmdWithoutParameter("/LDRS/score/list", this);
+    fListCmd->SetGuidance("list the configured scorers");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScorerMessenger::~ScorerMessenger()
+{
+    delete fAddCrossingCmd;
+    delete fClearCmd;
+    delete fListCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScorerMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fAddCrossingCmd) {
+        G4String from, to, ntuple;
+        std::istringstream is(newValue);
+        is >> from >> to >> ntuple;
+        fRegistry->AddScorer(from, to, ntuple);
+    }
+
+    if (command == fClearCmd) {
+        fRegistry->Clear();
+    }
+
+    if (command == fListCmd) {
+        fRegistry->List();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
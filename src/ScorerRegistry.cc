@@ -0,0 +1,143 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ScorerRegistry.cc
+/// \brief Implementation of the ScorerRegistry class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "ScorerRegistry.hh"
+
+#include "ScorerMessenger.hh"
+#include "HistoManager.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4PhysicalVolumeStore.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScorerRegistry::ScorerRegistry()
+{
+    // default planes: what leaves the catcher and the shielding tracker
+    AddScorer("CatcherLog", "World", "tree");
+    AddScorer("TrackerLog", "World", "shield");
+
+    fMessenger = new ScorerMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScorerRegistry::~ScorerRegistry()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScorerRegistry::AddScorer(const G4String& from, const G4String& to, const G4String& ntuple)
+{
+    Scorer scorer;
+    scorer.fFrom = from;
+    scorer.fTo = to;
+    if (ntuple == "tree")           scorer.fNtuple = HistoManager::kTree;
+    else if (ntuple == "shield")    scorer.fNtuple = HistoManager::kShield;
+    else                            scorer.fNtuple = HistoManager::kCrossing;
+    fScorers.push_back(scorer);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScorerRegistry::Clear()
+{
+    fScorers.clear();
+    fDense.clear();
+    fTable.assign(1, -1);
+    fNDense = 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScorerRegistry::List() const
+{
+    G4cout << " ---> Boundary-crossing scorers:" << G4endl;
+    for (std::size_t i = 0; i < fScorers.size(); i++) {
+        G4cout << "   " << i << ": " << fScorers[i].fFrom << " -> " << fScorers[i].fTo
+            << " (ntuple " << fScorers[i].fNtuple << ")" << G4endl;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScorerRegistry::Matches(const G4String& pattern, const G4VPhysicalVolume* pv) const
+{
+    if (pattern == "World") return pv->GetMotherLogical() == nullptr;
+    return pv->GetName() == pattern || pv->GetLogicalVolume()->GetName() == pattern;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScorerRegistry::Resolve()
+{
+    G4PhysicalVolumeStore* store = G4PhysicalVolumeStore::GetInstance();
+
+    // one extra ID past the last volume stands for "outside the world"
+    std::size_t maxID = 0;
+    for (auto pv : *store) maxID = std::max(maxID, (std::size_t)pv->GetInstanceID());
+    fOutsideID = maxID + 1;
+    fDense.assign(fOutsideID + 1, 0);
+
+    // dense indices only for volumes some scorer refers to
+    fNDense = 1;
+    for (auto pv : *store) {
+        for (const auto& scorer : fScorers) {
+            if (Matches(scorer.fFrom, pv) || Matches(scorer.fTo, pv)) {
+                fDense[pv->GetInstanceID()] = fNDense++;
+                break;
+            }
+        }
+    }
+
+    fTable.assign(fNDense * fNDense, -1);
+    G4int nPairs = 0;
+    for (auto pre : *store) {
+        for (auto post : *store) {
+            for (std::size_t i = 0; i < fScorers.size(); i++) {
+                if (Matches(fScorers[i].fFrom, pre) && Matches(fScorers[i].fTo, post)) {
+                    fTable[fDense[pre->GetInstanceID()] * fNDense + fDense[post->GetInstanceID()]] = i;
+                    nPairs++;
+                }
+            }
+        }
+    }
+
+    G4cout << " ---> Resolved " << fScorers.size() << " scorers onto " << nPairs 
+        << " volume pairs (" << fNDense - 1 << " volumes)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,188 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StackingAction.hh"
+
+#include "Run.hh"
+#include "StackingMessenger.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4ParticleTable.hh"
+#include "G4Region.hh"
+#include "G4RunManager.hh"
+#include "G4Track.hh"
+#include "G4UnitsTable.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction()
+{
+    fMessenger = new StackingMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StackingAction::FindPDG(const G4String& particle) const
+{
+    // particle name, or a PDG code for ions and anything not in the table yet
+    G4ParticleDefinition* def = G4ParticleTable::GetParticleTable()->FindParticle(particle);
+    if (def) return def->GetPDGEncoding();
+
+    std::istringstream is(particle);
+    G4int pdg = 0;
+    if (!(is >> pdg)) {
+        G4Exception("StackingAction::FindPDG()", "Stack01", JustWarning,
+                ("unknown particle " + particle + ", rule ignored").c_str());
+    }
+    return pdg;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddParticleRule(const G4String& particle)
+{
+    Rule rule;
+    rule.fType = kParticle;
+    rule.fPDG = FindPDG(particle);
+    rule.fName = "particle " + particle;
+    if (rule.fPDG != 0) fRules.push_back(rule);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddEnergyRule(const G4String& particle, G4double ekin)
+{
+    Rule rule;
+    rule.fType = kEnergy;
+    rule.fPDG = FindPDG(particle);
+    rule.fValue = ekin;
+    std::ostringstream os;
+    os << particle << " below " << G4BestUnit(ekin, "Energy");
+    rule.fName = os.str();
+    if (rule.fPDG != 0) fRules.push_back(rule);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddTimeRule(G4double time)
+{
+    Rule rule;
+    rule.fType = kTime;
+    rule.fValue = time;
+    std::ostringstream os;
+    os << "born after " << G4BestUnit(time, "Time");
+    rule.fName = os.str();
+    fRules.push_back(rule);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::AddBirthRule(const G4String& volume)
+{
+    Rule rule;
+    rule.fType = kBirth;
+    rule.fVolume = volume;
+    rule.fName = "born in " + volume;
+    fRules.push_back(rule);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::List() const
+{
+    G4cout << " ---> Stacking rules:" << G4endl;
+    for (std::size_t i = 0; i < fRules.size(); i++) {
+        G4cout << "   " << i << ": kill " << fRules[i].fName << G4endl;
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4String> StackingAction::GetRuleNames() const
+{
+    std::vector<G4String> names;
+    for (const auto& rule : fRules) names.push_back(rule.fName);
+    return names;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StackingAction::Matches(const Rule& rule, const G4Track* track) const
+{
+    switch (rule.fType) {
+        case kParticle:
+            return track->GetDefinition()->GetPDGEncoding() == rule.fPDG;
+        case kEnergy:
+            return track->GetDefinition()->GetPDGEncoding() == rule.fPDG
+                && track->GetKineticEnergy() < rule.fValue;
+        case kTime:
+            return track->GetGlobalTime() > rule.fValue;
+        case kBirth: {
+            // secondaries carry the touchable of the step that made them
+            const G4VPhysicalVolume* pv = track->GetVolume();
+            if (!pv) return false;
+            const G4LogicalVolume* lv = pv->GetLogicalVolume();
+            return pv->GetName() == rule.fVolume || lv->GetName() == rule.fVolume
+                || (lv->GetRegion() && lv->GetRegion()->GetName() == rule.fVolume);
+        }
+    }
+    return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+    if (track->GetParentID() == 0) return fUrgent;
+    // copies made by importance splitting carry on like their original
+    if (!track->GetCreatorProcess()) return fUrgent;
+
+    for (std::size_t i = 0; i < fRules.size(); i++) {
+        if (Matches(fRules[i], track)) {
+            Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+            run->CountStackKill(i);
+            return fKill;
+        }
+    }
+    return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
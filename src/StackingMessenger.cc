@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StackingMessenger.cc
+/// \brief Implementation of the StackingMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StackingMessenger.hh"
+
+#include "StackingAction.hh"
+
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingMessenger::StackingMessenger(StackingAction* stack) : fStacking(stack)
+{
+    fDir = new G4UIdirectory("/LDRS/stack/");
+    fDir->SetGuidance("rules for killing secondaries before they are tracked");
+
+    fKillParticleCmd = new G4UIcmdWithAString("/LDRS/stack/killParticle", this);
+    fKillParticleCmd->SetGuidance("kill all secondaries of a type (particle name or PDG code)");
+    fKillParticleCmd->SetParameterName("particle", false);
+    fKillParticleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEnergyCutCmd = new G4UIcommand("/LDRS/stack/energyCut", this);
+    fEnergyCutCmd->SetGuidance("kill secondaries of a type born below a kinetic energy");
+    fEnergyCutCmd->SetGuidance("[usage] /LDRS/stack/energyCut particle value unit");
+    auto particlePrm = new G4UIparameter("particle", 's', false);
+    fEnergyCutCmd->SetParameter(particlePrm);
+    auto valuePrm = new G4UIparameter("value", 'd', false);
+    valuePrm->SetParameterRange("value>=0.");
+    fEnergyCutCmd->SetParameter(valuePrm);
+    auto unitPrm = new G4UIparameter("unit", 's', true);
+    unitPrm->SetDefaultUnit("keV");
+    fEnergyCutCmd->SetParameter(unitPrm);
+    fEnergyCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fTimeCutCmd = new G4UIcmdWithADoubleAndUnit("/LDRS/stack/timeCut", this);
+    fTimeCutCmd->SetGuidance("kill secondaries born after a global time (end of the ToF window)");
+    fTimeCutCmd->SetParameterName("time", false);
+    fTimeCutCmd->SetRange("time>0.");
+    fTimeCutCmd->SetDefaultUnit("ns");
+    fTimeCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fKillBornInCmd = new G4UIcmdWithAString("/LDRS/stack/killBornIn", this);
+    fKillBornInCmd->SetGuidance("kill secondaries born in a volume (physical or logical name) or region");
+    fKillBornInCmd->SetParameterName("volume", false);
+    fKillBornInCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fClearCmd = new G4UIcmdWithoutParameter("/LDRS/stack/clear", this);
+    fClearCmd->SetGuidance("remove all stacking rules");
+    fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fListCmd = new G4UIcmdWithoutParameter("/LDRS/stack/list", this);
+    fListCmd->SetGuidance("list the stacking rules");
+    fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingMessenger::~StackingMessenger()
+{
+    delete fKillParticleCmd;
+    delete fEnergyCutCmd;
+    delete fTimeCutCmd;
+    delete fKillBornInCmd;
+    delete fClearCmd;
+    delete fListCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fKillParticleCmd) {
+        fStacking->AddParticleRule(newValue);
+    }
+
+    if (command == fEnergyCutCmd) {
+        G4String particle, unit;
+        G4double value;
+        std::istringstream is(newValue);
+        is >> particle >> value >> unit;
+        fStacking->AddEnergyRule(particle, value * G4UIcommand::ValueOf(unit));
+    }
+
+    if (command == fTimeCutCmd) {
+        fStacking->AddTimeRule(fTimeCutCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fKillBornInCmd) {
+        fStacking->AddBirthRule(newValue);
+    }
+
+    if (command == fClearCmd) {
+        fStacking->Clear();
+    }
+
+    if (command == fListCmd) {
+        fStacking->List();
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,127 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file StepProfile.cc
+/// \brief Implementation of the StepProfile class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "StepProfile.hh"
+
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <tuple>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfile::Merge(const StepProfile& other)
+{
+    other.fTable.ForEach([this](const Key& key, const Data& localData) {
+        Data& data = fTable[key];
+        data.fSteps += localData.fSteps;
+        data.fTracks += localData.fTracks;
+        data.fTime += localData.fTime;
+    });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfile::Report(const G4String& fileName) const
+{
+    // sum the per-thread objects by name
+    using Names = std::tuple<G4String, G4String, G4String>;
+    std::map<Names, Data> byName;
+    std::map<G4String, Data> byVolume;
+    std::map<G4String, Data> byParticle;
+    Data total;
+    fTable.ForEach([&](const Key& key, const Data& data) {
+        G4String volume = key.fVolume ? key.fVolume->GetName() : G4String("none");
+        G4String particle = key.fParticle ? key.fParticle->GetParticleName() : G4String("none");
+        G4String process = key.fProcess ? key.fProcess->GetProcessName() : G4String("none");
+        for (Data* sum : {&byName[Names(volume, particle, process)], &byVolume[volume],
+                          &byParticle[particle], &total}) {
+            sum->fSteps += data.fSteps;
+            sum->fTracks += data.fTracks;
+            sum->fTime += data.fTime;
+        }
+    });
+    if (total.fSteps == 0) return;
+
+    auto printSorted = [&total](const G4String& title, const auto& table, std::size_t nMax,
+                                const auto& label) {
+        std::vector<std::pair<G4String, Data>> rows;
+        for (const auto& entry : table) rows.emplace_back(label(entry.first), entry.second);
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+            return a.second.fTime > b.second.fTime;
+        });
+        G4cout << "\n " << title << G4endl;
+        G4cout << "  " << std::setw(50) << std::left << "" << std::right << std::setw(14) << "steps"
+            << std::setw(12) << "tracks" << std::setw(12) << "time [s]" << std::setw(8) << "%" << G4endl;
+        for (std::size_t i = 0; i < rows.size() && i < nMax; i++) {
+            const Data& data = rows[i].second;
+            G4cout << "  " << std::setw(50) << std::left << rows[i].first << std::right
+                << std::setw(14) << data.fSteps << std::setw(12) << data.fTracks
+                << std::setw(12) << std::setprecision(4) << data.fTime
+                << std::setw(8) << std::setprecision(3) << 100. * data.fTime / total.fTime << G4endl;
+        }
+    };
+
+    G4int dfprec = G4cout.precision();
+    G4cout << "\n -------------- Step profile (sampled wall time) -------------- " << G4endl;
+    G4cout << "  total: " << total.fSteps << " steps, " << total.fTracks << " tracks, "
+        << total.fTime << " s" << G4endl;
+    auto same = [](const G4String& name) { return name; };
+    printSorted("By volume:", byVolume, byVolume.size(), same);
+    printSorted("By particle:", byParticle, byParticle.size(), same);
+    printSorted("Top volume / particle / process:", byName, 25, [](const Names& names) {
+        return std::get<0>(names) + " / " + std::get<1>(names) + " / " + std::get<2>(names);
+    });
+    G4cout << " ------------------------------------------------------------- " << G4endl;
+    G4cout.precision(dfprec);
+
+    std::ofstream out(fileName);
+    if (!out) {
+        G4Exception("StepProfile::Report()", "Profile01", JustWarning,
+                ("cannot open " + fileName).c_str());
+        return;
+    }
+    out << "volume,particle,process,steps,tracks,time_s\n";
+    for (const auto& entry : byName) {
+        out << std::get<0>(entry.first) << "," << std::get<1>(entry.first) << ","
+            << std::get<2>(entry.first) << "," << entry.second.fSteps << ","
+            << entry.second.fTracks << "," << entry.second.fTime << "\n";
+    }
+    G4cout << " ---> Step profile written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
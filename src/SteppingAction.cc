@@ -35,233 +35,412 @@
 #include "HistoManager.hh"
 #include "Run.hh"
 #include "DetectorConstruction.hh"
+#include "ScorerRegistry.hh"
+#include "KillZones.hh"
+#include "ImportanceBiasing.hh"
+#include "StepProfile.hh"
+#include "VoxelMap.hh"
+#include "PixelImage.hh"
 
+#include "G4DynamicParticle.hh"
 #include "G4HadronicProcess.hh"
+#include "G4Isotope.hh"
 #include "G4ParticleTypes.hh"
 #include "G4RunManager.hh"
+#include "G4SteppingManager.hh"
+#include "Randomize.hh"
 
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
+#include <algorithm>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-// SteppingAction::SteppingAction()
-//: G4UserSteppingAction()
-//{ }
+SteppingAction::SteppingAction(DetectorConstruction* det) : G4UserSteppingAction(), fDetector(det)
+{
+    fScorers = fDetector->GetScorers();
+    fKillZones = fDetector->GetKillZones();
+    fBiasing = fDetector->GetBiasing();
+    fWeightWindows = fDetector->GetWeightWindows();
+    fEstimator = fDetector->GetImageEstimator();
+    fPipeline = GetPipeline(0);
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-SteppingAction::SteppingAction(DetectorConstruction* det) : G4UserSteppingAction(), fDetector(det)
-{}
+void SteppingAction::Score(const G4Step* aStep, G4int scorer)
+{
+    const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+    const G4ThreeVector& position = postPoint->GetPosition();
+    G4ThreeVector momentum = postPoint->GetMomentum();
+
+    G4int idx = fScorers->GetScorer(scorer).fNtuple;
+    NtupleBuffer* buffer = HistoManager::GetBuffer(idx);
+    std::size_t row = buffer->NextRow();
+    buffer->Set(0, row, aStep->GetTrack()->GetDefinition()->GetPDGEncoding());
+    buffer->Set(1, row, postPoint->GetKineticEnergy() / MeV);
+    buffer->Set(2, row, postPoint->GetGlobalTime() / ns);
+    buffer->Set(3, row, position.x() / mm);
+    buffer->Set(4, row, position.y() / mm);
+    buffer->Set(5, row, position.z() / mm);
+    buffer->Set(6, row, momentum.x());
+    buffer->Set(7, row, momentum.y());
+    buffer->Set(8, row, momentum.z());
+    // the crossing ntuple has the scorer index before the weight
+    G4double weight = aStep->GetTrack()->GetWeight();
+    if (idx == HistoManager::kCrossing) {
+        buffer->Set(9, row, scorer);
+        buffer->Set(10, row, weight);
+    }
+    else {
+        buffer->Set(9, row, weight);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::AnalyseInteraction(const G4Step* aStep)
+{
+    // first interaction of the primary particle only
+    const G4Track* track = aStep->GetTrack();
+    if (track->GetTrackID() * track->GetCurrentStepNumber() != 1) return;
+
+    Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+
+    // count processes
+    //
+    const G4StepPoint* endPoint = aStep->GetPostStepPoint();
+    const G4VProcess* process = endPoint->GetProcessDefinedStep();
+    run->CountProcesses(process);
+
+    // check that an real interaction occured (eg. not a transportation)
+    G4StepStatus stepStatus = endPoint->GetStepStatus();
+    G4bool transmit = (stepStatus == fGeomBoundary || stepStatus == fWorldBoundary);
+    if (transmit) return;
+
+    // real processes : sum track length
+    //
+    run->SumTrack(aStep->GetStepLength());
+
+    // energy-momentum balance initialisation
+    //
+    const G4StepPoint* prePoint = aStep->GetPreStepPoint();
+    G4double Q = -prePoint->GetKineticEnergy();
+    G4ThreeVector Pbalance = -prePoint->GetMomentum();
+
+    // nuclear channel key: projectile and target isotope
+    //
+    Run::ChannelKey key;
+    key.fProjectile = track->GetDefinition()->GetPDGEncoding();
+    G4HadronicProcess* hproc = dynamic_cast<G4HadronicProcess*>(const_cast<G4VProcess*>(process));
+    const G4Isotope* target = hproc ? hproc->GetTargetIsotope() : nullptr;
+    if (target) key.fTarget = target->GetIndex() + 1;
+    else run->SetTargetXXX(true);
+
+    // scattered primary particle (if any)
+    //
+    fProducts.clear();
+    if (track->GetTrackStatus() == fAlive) {
+        Q += endPoint->GetKineticEnergy();
+        Pbalance += endPoint->GetMomentum();
+        fProducts.push_back(key.fProjectile);
+    }
+
+    // secondaries
+    //
+    const std::vector<const G4Track*>* secondary = aStep->GetSecondaryInCurrentStep();
+    for (const G4Track* sec : *secondary) {
+        G4int pdg = sec->GetDefinition()->GetPDGEncoding();
+        G4double energy = sec->GetKineticEnergy();
+        run->ParticleCount(pdg, energy);
+        // energy-momentum balance
+        Q += energy;
+        Pbalance += sec->GetMomentum();
+        // count e- from internal conversion together with gamma
+        fProducts.push_back(pdg == 11 ? 22 : pdg);
+    }
+
+    // energy-momentum balance
+    run->Balance(Pbalance.mag());
+
+    // products as a sorted multiset: (species, multiplicity) pairs
+    //
+    const G4int kMax = 16;
+    G4bool overflow = false;
+    std::sort(fProducts.begin(), fProducts.end());
+    for (std::size_t i = 0; i < fProducts.size(); ) {
+        std::size_t j = i;
+        while (j < fProducts.size() && fProducts[j] == fProducts[i]) j++;
+        G4int nb = std::min((G4int)(j - i), kMax);
+        if (fProducts[i] == 22) {
+            run->CountGamma(nb);
+            nb = 1;
+        }
+        if (key.fNSpecies < Run::kMaxSpecies) {
+            key.fPDG[key.fNSpecies] = fProducts[i];
+            key.fCount[key.fNSpecies] = nb;
+            key.fNSpecies++;
+        }
+        else {
+            overflow = true;
+        }
+        i = j;
+    }
+    if (overflow) run->CountSpeciesOverflow();
+
+    run->CountNuclearChannel(key, Q);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void SteppingAction::Cull(const G4Step* aStep)
+{
+    // neutrals leaving the components into world air on a line that
+    // misses the panels
+    const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+    G4Track* track = aStep->GetTrack();
+    if (postPoint->GetStepStatus() == fGeomBoundary
+            && postPoint->GetPhysicalVolume() && !postPoint->GetPhysicalVolume()->GetMotherLogical()
+            && track->GetDefinition()->GetPDGCharge() == 0.
+            && fKillZones->OutsideComponents(postPoint->GetPosition())
+            && fKillZones->MissesPanels(postPoint->GetPosition(), postPoint->GetMomentumDirection())) {
+        G4double survival = fKillZones->GetCullSurvival();
+        if (survival > 0. && G4UniformRand() < survival) {
+            track->SetWeight(track->GetWeight() / survival);
+        }
+        else {
+            track->SetTrackStatus(fStopAndKill);
+            Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+            const G4ParticleDefinition* particle = track->GetDefinition();
+            run->CountCull(particle == G4Neutron::Definition() ? Run::kCullNeutron
+                         : particle == G4Gamma::Definition() ? Run::kCullGamma : Run::kCullOther);
+        }
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void SteppingAction::Kill(const G4Step* aStep)
+{
+    G4Track* track = aStep->GetTrack();
+    if (track->GetTrackStatus() != fAlive) return;
+    G4int zone = fKillZones->Find(aStep->GetPostStepPoint()->GetPosition());
+    if (zone >= 0) {
+        track->SetTrackStatus(fStopAndKill);
+        Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+        const G4ParticleDefinition* particle = track->GetDefinition();
+        run->CountKill(zone, particle == G4Neutron::Definition() ? Run::kKillNeutron
+                           : particle == G4Gamma::Definition() ? Run::kKillGamma
+                           : particle == G4Electron::Definition() ? Run::kKillElectron : Run::kKillOther);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void SteppingAction::Bias(const G4Step* aStep)
+{
+    G4Track* track = aStep->GetTrack();
+    if (track->GetTrackStatus() != fAlive) return;
+    G4double importance = fBiasing->Importance(aStep->GetPostStepPoint());
+    if (importance <= 0.) return;
+
+    // the weight holds 1/importance of the last cell the track was in
+    G4double ratio = importance * track->GetWeight();
+    if (std::abs(ratio - 1.) < 1.e-6) return;
+
+    Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    if (ratio < 1.) {
+        if (G4UniformRand() < ratio) {
+            track->SetWeight(1. / importance);
+            run->CountRoulette(true);
+        }
+        else {
+            track->SetTrackStatus(fStopAndKill);
+            run->CountRoulette(false);
+        }
+        return;
+    }
+
+    // floor(ratio) or floor(ratio)+1 tracks of weight 1/importance, ratio
+    // on average; past the split limit the weight is shared instead
+    G4int n = (G4int)ratio;
+    if (G4UniformRand() < ratio - n) n++;
+    G4int maxSplit = fBiasing->GetMaxSplit();
+    if (n > maxSplit) Split(track, maxSplit, track->GetWeight() / maxSplit);
+    else Split(track, n, 1. / importance);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::Split(G4Track* track, G4int n, G4double weight)
+{
+    track->SetWeight(weight);
+    if (n < 2) return;
+    G4TrackVector* secondaries = fpSteppingManager->GetfSecondary();
+    for (G4int i = 1; i < n; i++) {
+        // copies have no creator process, which keeps them clear of the stacking rules
+        auto copy = new G4Track(new G4DynamicParticle(*track->GetDynamicParticle()),
+                                track->GetGlobalTime(), track->GetPosition());
+        copy->SetWeight(weight);
+        copy->SetParentID(track->GetTrackID());
+        copy->SetTouchableHandle(track->GetTouchableHandle());
+        copy->SetLocalTime(track->GetLocalTime());
+        copy->SetProperTime(track->GetProperTime());
+        copy->AddTrackLength(track->GetTrackLength());
+        secondaries->push_back(copy);
+    }
+    Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    run->CountSplit(n - 1);
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void SteppingAction::UserSteppingAction(const G4Step* aStep)
+inline void SteppingAction::Window(const G4Step* aStep)
 {
-    G4AnalysisManager* analysis = G4AnalysisManager::Instance();
-    
-    // check trackID and stepNumber
-    G4int trackID = aStep->GetTrack()->GetTrackID();
-    G4int stepNb = aStep->GetTrack()->GetCurrentStepNumber();
-
-    // check if world -> catcher
-    if (aStep->GetPreStepPoint()->GetPhysicalVolume()  == fDetector->GetCatcher() && 
-        aStep->GetPostStepPoint()->GetPhysicalVolume() == fDetector->GetWorld()) 
-    {
-        G4double particleID     = aStep->GetTrack()->GetDefinition()->GetPDGEncoding();
-        G4double ekin           = aStep->GetPostStepPoint()->GetKineticEnergy();
-        G4double t              = aStep->GetPostStepPoint()->GetGlobalTime();
-        G4ThreeVector position  = aStep->GetPostStepPoint()->GetPosition();
-        G4ThreeVector momentum  = aStep->GetPostStepPoint()->GetMomentum();
-
-        G4int idx = 0;
-        //if(momentum.z() > 0) {
-        if(1) {
-            //G4ParticleDefinition* particle = aStep->GetTrack()->GetDefinition();
-            //G4String partName = particle->GetParticleName();
-
-            // 0-index ntuple is for generating neutron phase space
-            analysis->FillNtupleDColumn(idx, 0, particleID);
-            analysis->FillNtupleDColumn(idx, 1, ekin / MeV);
-            analysis->FillNtupleDColumn(idx, 2, t / ns);
-            analysis->FillNtupleDColumn(idx, 3, position.x() / mm);
-            analysis->FillNtupleDColumn(idx, 4, position.y() / mm);
-            analysis->FillNtupleDColumn(idx, 5, position.z() / mm);
-            analysis->FillNtupleDColumn(idx, 6, momentum.x());
-            analysis->FillNtupleDColumn(idx, 7, momentum.y());
-            analysis->FillNtupleDColumn(idx, 8, momentum.z());
-            analysis->AddNtupleRow(idx);
+    G4Track* track = aStep->GetTrack();
+    if (track->GetTrackStatus() != fAlive) return;
+    const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+    G4int cell = fWeightWindows->Cell(postPoint->GetPosition(), postPoint->GetKineticEnergy());
+
+    // pilot: weight entering each cell, births included; split copies
+    // (no creator process) are not births, their parent already entered
+    // with the weight they share
+    if (fWindowTally) {
+        const G4StepPoint* prePoint = aStep->GetPreStepPoint();
+        G4int preCell = fWeightWindows->Cell(prePoint->GetPosition(), prePoint->GetKineticEnergy());
+        G4bool born = track->GetParentID() == 0 || track->GetCreatorProcess();
+        if (track->GetCurrentStepNumber() == 1 && born && preCell >= 0) fWindowTally->Enter(preCell, prePoint->GetWeight());
+        if (cell >= 0 && cell != preCell) fWindowTally->Enter(cell, track->GetWeight());
+    }
+
+    if (cell < 0 || !fWeightWindows->IsApplied()) return;
+    G4double lower = fWeightWindows->GetLower(cell);
+    if (lower <= 0.) return;
+
+    G4double weight = track->GetWeight();
+    G4double upper = lower * fWeightWindows->GetRatio();
+    if (weight < lower) {
+        // roulette up to the survival weight, the middle of the window
+        G4double survival = 0.5 * (lower + upper);
+        Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+        if (G4UniformRand() * survival < weight) {
+            track->SetWeight(survival);
+            run->CountRoulette(true);
+        }
+        else {
+            track->SetTrackStatus(fStopAndKill);
+            run->CountRoulette(false);
         }
     }
-    
-    
-    // check if shielding tracker -> world
-    if (aStep->GetPreStepPoint()->GetPhysicalVolume()  == fDetector->GetShieldingTracker() && 
-        aStep->GetPostStepPoint()->GetPhysicalVolume() == fDetector->GetWorld()) 
-    {
-        G4double particleID     = aStep->GetTrack()->GetDefinition()->GetPDGEncoding();
-        G4double ekin           = aStep->GetPostStepPoint()->GetKineticEnergy();
-        G4double t              = aStep->GetPostStepPoint()->GetGlobalTime();
-        G4ThreeVector position  = aStep->GetPostStepPoint()->GetPosition();
-        G4ThreeVector momentum  = aStep->GetPostStepPoint()->GetMomentum();
-
-        G4int idx = 2;
-        //if(momentum.z() > 0) {
-        if(1) {
-            //G4ParticleDefinition* particle = aStep->GetTrack()->GetDefinition();
-            //G4String partName = particle->GetParticleName();
-
-            // 0-index ntuple is for generating neutron phase space
-            analysis->FillNtupleDColumn(idx, 0, particleID);
-            analysis->FillNtupleDColumn(idx, 1, ekin / MeV);
-            analysis->FillNtupleDColumn(idx, 2, t / ns);
-            analysis->FillNtupleDColumn(idx, 3, position.x() / mm);
-            analysis->FillNtupleDColumn(idx, 4, position.y() / mm);
-            analysis->FillNtupleDColumn(idx, 5, position.z() / mm);
-            analysis->FillNtupleDColumn(idx, 6, momentum.x());
-            analysis->FillNtupleDColumn(idx, 7, momentum.y());
-            analysis->FillNtupleDColumn(idx, 8, momentum.z());
-            analysis->AddNtupleRow(idx);
+    else if (weight > upper) {
+        G4int n = std::min((G4int)std::ceil(weight / upper), fBiasing->GetMaxSplit());
+        Split(track, n, weight / n);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void SteppingAction::Estimate(const G4Step* aStep)
+{
+    // with the pre-collision weight, before any stage below changes it
+    if (fEstimator->IsNextEvent()) fEstimator->ScoreCollision(aStep, fTracer, fEstimatorImage);
+    if (fEstimator->IsTrackLength()) fEstimator->ScoreTrack(aStep, fEstimatorImage);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <unsigned Stages>
+void SteppingAction::Step(const G4Step* aStep)
+{
+    if (Has<Stages>(kProfile)) fProfile->Fill(aStep);
+    if (Has<Stages>(kVoxel)) fVoxelMap->Fill(aStep);
+
+    // boundary-crossing scorers
+    if (Has<Stages>(kScore)) {
+        const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+        if (postPoint->GetStepStatus() == fGeomBoundary) {
+            G4int scorer = fScorers->Lookup(aStep->GetPreStepPoint()->GetPhysicalVolume(), 
+                                            postPoint->GetPhysicalVolume());
+            if (scorer >= 0) Score(aStep, scorer);
         }
     }
 
+    if (Has<Stages>(kAnalysis)) AnalyseInteraction(aStep);
+    if (Has<Stages>(kEstimate)) Estimate(aStep);
+
+    // kill stages come last so that a crossing into a zone is still scored
+    if (Has<Stages>(kCull)) Cull(aStep);
+    if (Has<Stages>(kKill)) Kill(aStep);
 
-    // // 
-    // if (trackID * stepNb != 1) return;
-    // // ok, we are at first interaction of the primary particle
-
-    // Run* run = static_cast<Run*>(G4RunManager::GetRunManager()->GetNonConstCurrentRun());
-
-    // // count processes
-    // //
-    // const G4StepPoint* endPoint = aStep->GetPostStepPoint();
-    // G4VProcess* process = const_cast<G4VProcess*>(endPoint->GetProcessDefinedStep());
-    // run->CountProcesses(process);
-
-    // // check that an real interaction occured (eg. not a transportation)
-    // G4StepStatus stepStatus = endPoint->GetStepStatus();
-    // G4bool transmit = (stepStatus == fGeomBoundary || stepStatus == fWorldBoundary);
-    // if (transmit) return;
-
-    // // real processes : sum track length
-    // //
-    // G4double stepLength = aStep->GetStepLength();
-    // run->SumTrack(stepLength);
-
-    // // energy-momentum balance initialisation
-    // //
-    // const G4StepPoint* prePoint = aStep->GetPreStepPoint();
-    // G4double Q = -prePoint->GetKineticEnergy();
-    // G4ThreeVector Pbalance = -prePoint->GetMomentum();
-
-    // // initialisation of the nuclear channel identification
-    // //
-    // G4ParticleDefinition* particle = aStep->GetTrack()->GetDefinition();
-    // G4String partName = particle->GetParticleName();
-    // G4String nuclearChannel = partName;
-    // G4HadronicProcess* hproc = dynamic_cast<G4HadronicProcess*>(process);
-    // const G4Isotope* target = NULL;
-    // if (hproc) target = hproc->GetTargetIsotope();
-    // G4String targetName = "XXXX";
-    // if (target) targetName = target->GetName();
-    // nuclearChannel += " + " + targetName + " --> ";
-    // if (targetName == "XXXX") run->SetTargetXXX(true);
-
-    // // scattered primary particle (if any)
-    // //
-    // G4int ih = 1;
-    // if (aStep->GetTrack()->GetTrackStatus() == fAlive) {
-    //     G4double energy = endPoint->GetKineticEnergy();
-    //     analysis->FillH1(ih, energy);
-    //     //
-    //     G4ThreeVector momentum = endPoint->GetMomentum();
-    //     Q += energy;
-    //     Pbalance += momentum;
-    //     //
-    //     nuclearChannel += partName + " + ";
-    // }
-
-    // // secondaries
-    // //
-    // const std::vector<const G4Track*>* secondary = aStep->GetSecondaryInCurrentStep();
-    // for (size_t lp = 0; lp < (*secondary).size(); lp++) {
-    //     particle = (*secondary)[lp]->GetDefinition();
-    //     G4String name = particle->GetParticleName();
-    //     G4String type = particle->GetParticleType();
-    //     G4double energy = (*secondary)[lp]->GetKineticEnergy();
-    //     run->ParticleCount(name, energy);
-    //     // energy spectrum
-    //     ih = 0;
-    //     if (particle == G4Gamma::Gamma())
-    //         ih = 2;
-    //     else if (particle == G4Electron::Electron())
-    //         ih = 3;
-    //     else if (particle == G4Neutron::Neutron())
-    //         ih = 4;
-    //     else if (particle == G4Proton::Proton())
-    //         ih = 5;
-    //     else if (particle == G4Deuteron::Deuteron())
-    //         ih = 6;
-    //     else if (particle == G4Alpha::Alpha())
-    //         ih = 7;
-    //     else if (type == "nucleus")
-    //         ih = 8;
-    //     else if (type == "meson")
-    //         ih = 9;
-    //     else if (type == "baryon")
-    //         ih = 10;
-    //     if (ih > 0) analysis->FillH1(ih, energy);
-    //     // atomic mass
-    //     if (type == "nucleus") {
-    //         G4int A = particle->GetAtomicMass();
-    //         analysis->FillH1(13, A);
-    //     }
-    //     // energy-momentum balance
-    //     G4ThreeVector momentum = (*secondary)[lp]->GetMomentum();
-    //     Q += energy;
-    //     Pbalance += momentum;
-    //     // count e- from internal conversion together with gamma
-    //     if (particle == G4Electron::Electron()) particle = G4Gamma::Gamma();
-    //     // particle flag
-    //     fParticleFlag[particle]++;
-    // }
-
-    // // energy-momentum balance
-    // G4double Pbal = Pbalance.mag();
-    // run->Balance(Pbal);
-    // ih = 11;
-    // analysis->FillH1(ih, Q);
-    // ih = 12;
-    // analysis->FillH1(ih, Pbal);
-
-    // // nuclear channel
-    // const G4int kMax = 16;
-    // const G4String conver[] = {"0",  "",    "2 ",  "3 ",  "4 ",  "5 ",  "6 ",  "7 ", "8 ",
-    //     "9 ", "10 ", "11 ", "12 ", "13 ", "14 ", "15 ", "16 "};
-    // std::map<G4ParticleDefinition*, G4int>::iterator ip;
-    // for (ip = fParticleFlag.begin(); ip != fParticleFlag.end(); ip++) {
-    //     particle = ip->first;
-    //     G4String name = particle->GetParticleName();
-    //     G4int nb = ip->second;
-    //     if (nb > kMax) nb = kMax;
-    //     G4String Nb = conver[nb];
-    //     if (particle == G4Gamma::Gamma()) {
-    //         run->CountGamma(nb);
-    //         Nb = "N ";
-    //         name = "gamma or e-";
-    //     }
-    //     if (ip != fParticleFlag.begin()) nuclearChannel += " + ";
-    //     nuclearChannel += Nb + name;
-    // }
-
-    // /// G4cout << "\n nuclear channel: " << nuclearChannel << G4endl;
-    // run->CountNuclearChannel(nuclearChannel, Q);
-
-    // fParticleFlag.clear();
-
-    // // kill event after first interaction
-    // //
-    // //G4RunManager::GetRunManager()->AbortEvent();
+    // on survivors only
+    if (Has<Stages>(kBias)) Bias(aStep);
+    if (Has<Stages>(kWindow)) Window(aStep);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// configurations with a pipeline of their own: scoring with one of the
+// variance reduction or diagnostic stages; the generic one comes last
+static constexpr unsigned kPipelineStages[] = {
+    0,
+    SteppingAction::kScore,
+    SteppingAction::kScore | SteppingAction::kAnalysis,
+    SteppingAction::kScore | SteppingAction::kKill,
+    SteppingAction::kScore | SteppingAction::kCull,
+    SteppingAction::kScore | SteppingAction::kCull | SteppingAction::kKill,
+    SteppingAction::kScore | SteppingAction::kProfile,
+    SteppingAction::kScore | SteppingAction::kVoxel,
+    SteppingAction::kScore | SteppingAction::kProfile | SteppingAction::kVoxel,
+    SteppingAction::kScore | SteppingAction::kBias,
+    SteppingAction::kScore | SteppingAction::kWindow,
+    SteppingAction::kScore | SteppingAction::kEstimate,
+    SteppingAction::kGeneric
+};
+
+template <std::size_t... Index>
+std::array<SteppingAction::Pipeline, sizeof...(Index)> 
+SteppingAction::MakePipelines(std::index_sequence<Index...>)
+{
+    return {{ &SteppingAction::Step<kPipelineStages[Index]>... }};
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingAction::Pipeline SteppingAction::GetPipeline(unsigned stages)
+{
+    constexpr std::size_t n = sizeof(kPipelineStages) / sizeof(kPipelineStages[0]);
+    static const auto pipelines = MakePipelines(std::make_index_sequence<n>());
+    for (std::size_t i = 0; i < n - 1; i++) {
+        if (kPipelineStages[i] == stages) return pipelines[i];
+    }
+    return pipelines[n - 1];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::SelectPipeline()
+{
+    unsigned stages = 0;
+    if (!fScorers->IsEmpty())       stages |= kScore;
+    if (fChannelAnalysis)           stages |= kAnalysis;
+    if (fKillZones->IsCulling())    stages |= kCull;
+    if (!fKillZones->IsEmpty())     stages |= kKill;
+    if (fProfile)                   stages |= kProfile;
+    if (fVoxelMap)                  stages |= kVoxel;
+    if (fWindowTally || fWeightWindows->IsApplied())  stages |= kWindow;
+    // the windows (and their pilots) already split and roulette on the
+    // cell weights; layer importances on top would bias the same tracks twice
+    if (!fBiasing->IsEmpty()) {
+        if (stages & kWindow) {
+            G4Exception("SteppingAction::SelectPipeline()", "Step01", JustWarning,
+                        "weight windows (or their pilot) active, importance layers ignored");
+        }
+        else stages |= kBias;
+    }
+    if (fEstimatorImage)            stages |= kEstimate;
+    fStages = stages;
+    fPipeline = GetPipeline(stages);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
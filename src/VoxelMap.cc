@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file VoxelMap.cc
+/// \brief Implementation of the VoxelMap class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "VoxelMap.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include "TFile.h"
+#include "TH3D.h"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelMap::Configure(G4int nx, G4int ny, G4int nz, const G4ThreeVector& lo, const G4ThreeVector& hi,
+                         G4bool split, G4int sampling)
+{
+    fN[0] = nx;
+    fN[1] = ny;
+    fN[2] = nz;
+    fNVoxels = (std::size_t)nx * ny * nz;
+    fLo = lo;
+    fHi = hi;
+    fInvWidth = G4ThreeVector(nx / (hi.x() - lo.x()), ny / (hi.y() - lo.y()), nz / (hi.z() - lo.z()));
+    fSplit = split;
+
+    std::size_t size = fNVoxels * (fSplit ? kNCategories : 1);
+    fSteps.assign(size, 0.);
+    fTime.assign(size, 0.);
+    fTimer.SetSampling(sampling);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelMap::Merge(const VoxelMap& other)
+{
+    if (other.fSteps.size() != fSteps.size()) return;
+    for (std::size_t i = 0; i < fSteps.size(); i++) {
+        fSteps[i] += other.fSteps[i];
+        fTime[i] += other.fTime[i];
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void VoxelMap::Write(const G4String& fileName) const
+{
+    if (!IsConfigured()) return;
+
+    TFile* file = TFile::Open(fileName.c_str(), "RECREATE");
+    if (!file || file->IsZombie()) {
+        G4Exception("VoxelMap::Write()", "Voxel01", JustWarning, ("cannot open " + fileName).c_str());
+        delete file;
+        return;
+    }
+
+    const char* categories[kNCategories] = {"n", "gamma", "e", "p", "other"};
+    G4int nCategories = fSplit ? kNCategories : 1;
+    for (G4int c = 0; c < nCategories; c++) {
+        G4String suffix = fSplit ? G4String("_") + categories[c] : G4String("");
+        TH3D hSteps(("hStepDensity" + suffix).c_str(), "steps;x [mm];y [mm];z [mm]",
+                fN[0], fLo.x() / mm, fHi.x() / mm, fN[1], fLo.y() / mm, fHi.y() / mm,
+                fN[2], fLo.z() / mm, fHi.z() / mm);
+        TH3D hTime(("hTimeDensity" + suffix).c_str(), "sampled wall time [s];x [mm];y [mm];z [mm]",
+                fN[0], fLo.x() / mm, fHi.x() / mm, fN[1], fLo.y() / mm, fHi.y() / mm,
+                fN[2], fLo.z() / mm, fHi.z() / mm);
+        std::size_t offset = c * fNVoxels;
+        for (G4int iz = 0; iz < fN[2]; iz++) {
+            for (G4int iy = 0; iy < fN[1]; iy++) {
+                for (G4int ix = 0; ix < fN[0]; ix++) {
+                    std::size_t voxel = offset + ((std::size_t)iz * fN[1] + iy) * fN[0] + ix;
+                    if (fSteps[voxel] == 0.) continue;
+                    hSteps.SetBinContent(ix + 1, iy + 1, iz + 1, fSteps[voxel]);
+                    hTime.SetBinContent(ix + 1, iy + 1, iz + 1, fTime[voxel]);
+                }
+            }
+        }
+        hSteps.SetEntries(hSteps.Integral());
+        hSteps.Write();
+        hTime.Write();
+    }
+    file->Close();
+    delete file;
+
+    G4cout << " ---> Step and time density maps written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,212 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file WeightWindowMessenger.cc
+/// \brief Implementation of the WeightWindowMessenger class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "WeightWindowMessenger.hh"
+
+#include "WeightWindows.hh"
+
+#include "G4RunManager.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcommand.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WeightWindowMessenger::WeightWindowMessenger(WeightWindows* windows) : fWindows(windows)
+{
+    fDir = new G4UIdirectory("/LDRS/ww/");
+    fDir->SetGuidance("space-energy weight windows from pilot runs");
+
+    fMeshCmd = new G4UIcommand("/LDRS/ww/setMesh", this);
+    fMeshCmd->SetGuidance("number of mesh cells along x, y and z");
+    for (auto name : {"nx", "ny", "nz"}) {
+        auto prm = new G4UIparameter(name, 'i', false);
+        prm->SetParameterRange(G4String(name) + ">0");
+        fMeshCmd->SetParameter(prm);
+    }
+    fMeshCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fBoxCmd = new G4UIcommand("/LDRS/ww/setBox", this);
+    fBoxCmd->SetGuidance("world-frame box covered by the mesh (default: the world)");
+    fBoxCmd->SetGuidance("[usage] /LDRS/ww/setBox xlo ylo zlo xhi yhi zhi unit");
+    for (auto name : {"xlo", "ylo", "zlo", "xhi", "yhi", "zhi"}) {
+        auto prm = new G4UIparameter(name, 'd', false);
+        fBoxCmd->SetParameter(prm);
+    }
+    auto boxUnitPrm = new G4UIparameter("unit", 's', true);
+    boxUnitPrm->SetDefaultUnit("mm");
+    fBoxCmd->SetParameter(boxUnitPrm);
+    fBoxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fEnergyCmd = new G4UIcommand("/LDRS/ww/setEnergyGroups", this);
+    fEnergyCmd->SetGuidance("log-spaced energy groups of the mesh");
+    fEnergyCmd->SetGuidance("[usage] /LDRS/ww/setEnergyGroups n emin emax unit");
+    auto groupsPrm = new G4UIparameter("n", 'i', false);
+    groupsPrm->SetParameterRange("n>0");
+    fEnergyCmd->SetParameter(groupsPrm);
+    for (auto name : {"emin", "emax"}) {
+        auto prm = new G4UIparameter(name, 'd', false);
+        prm->SetParameterRange(G4String(name) + ">0.");
+        fEnergyCmd->SetParameter(prm);
+    }
+    auto energyUnitPrm = new G4UIparameter("unit", 's', true);
+    energyUnitPrm->SetDefaultUnit("MeV");
+    fEnergyCmd->SetParameter(energyUnitPrm);
+    fEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fRatioCmd = new G4UIcmdWithADouble("/LDRS/ww/setRatio", this);
+    fRatioCmd->SetGuidance("upper over lower bound of each window");
+    fRatioCmd->SetParameterName("ratio", false);
+    fRatioCmd->SetRange("ratio>1.");
+    fRatioCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fPilotCmd = new G4UIcmdWithABool("/LDRS/ww/setPilot", this);
+    fPilotCmd->SetGuidance("estimate cell importances in the next runs and update the windows");
+    fPilotCmd->SetParameterName("pilot", false);
+    fPilotCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fApplyCmd = new G4UIcmdWithABool("/LDRS/ww/setApply", this);
+    fApplyCmd->SetGuidance("split and roulette tracks against the current windows");
+    fApplyCmd->SetParameterName("apply", false);
+    fApplyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fFileCmd = new G4UIcmdWithAString("/LDRS/ww/setFile", this);
+    fFileCmd->SetGuidance("file written after each pilot run");
+    fFileCmd->SetParameterName("file", false);
+    fFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fLoadCmd = new G4UIcmdWithAString("/LDRS/ww/load", this);
+    fLoadCmd->SetGuidance("read windows (and their mesh) written by an earlier pilot");
+    fLoadCmd->SetParameterName("file", false);
+    fLoadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    fGenerateCmd = new G4UIcommand("/LDRS/ww/generate", this);
+    fGenerateCmd->SetGuidance("run pilot iterations, each with the previous windows applied,");
+    fGenerateCmd->SetGuidance("then leave the windows applied for the production run");
+    fGenerateCmd->SetGuidance("[usage] /LDRS/ww/generate nIterations nEvents");
+    auto iterPrm = new G4UIparameter("nIterations", 'i', false);
+    iterPrm->SetParameterRange("nIterations>0");
+    fGenerateCmd->SetParameter(iterPrm);
+    auto eventsPrm = new G4UIparameter("nEvents", 'i', false);
+    eventsPrm->SetParameterRange("nEvents>0");
+    fGenerateCmd->SetParameter(eventsPrm);
+    fGenerateCmd->AvailableForStates(G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WeightWindowMessenger::~WeightWindowMessenger()
+{
+    delete fMeshCmd;
+    delete fBoxCmd;
+    delete fEnergyCmd;
+    delete fRatioCmd;
+    delete fPilotCmd;
+    delete fApplyCmd;
+    delete fFileCmd;
+    delete fLoadCmd;
+    delete fGenerateCmd;
+    delete fDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindowMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+    if (command == fMeshCmd) {
+        G4int nx, ny, nz;
+        std::istringstream is(newValue);
+        is >> nx >> ny >> nz;
+        fWindows->SetMesh(nx, ny, nz);
+    }
+
+    if (command == fBoxCmd) {
+        G4double xlo, ylo, zlo, xhi, yhi, zhi;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> xlo >> ylo >> zlo >> xhi >> yhi >> zhi >> unit;
+        G4double u = G4UIcommand::ValueOf(unit);
+        fWindows->SetBox(G4ThreeVector(xlo, ylo, zlo) * u, G4ThreeVector(xhi, yhi, zhi) * u);
+    }
+
+    if (command == fEnergyCmd) {
+        G4int n;
+        G4double emin, emax;
+        G4String unit;
+        std::istringstream is(newValue);
+        is >> n >> emin >> emax >> unit;
+        G4double u = G4UIcommand::ValueOf(unit);
+        fWindows->SetEnergyGroups(n, emin * u, emax * u);
+    }
+
+    if (command == fRatioCmd) {
+        fWindows->SetRatio(fRatioCmd->GetNewDoubleValue(newValue));
+    }
+
+    if (command == fPilotCmd) {
+        fWindows->SetPilot(fPilotCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fApplyCmd) {
+        fWindows->SetApply(fApplyCmd->GetNewBoolValue(newValue));
+    }
+
+    if (command == fFileCmd) {
+        fWindows->SetFile(newValue);
+    }
+
+    if (command == fLoadCmd) {
+        fWindows->Load(newValue);
+    }
+
+    if (command == fGenerateCmd) {
+        G4int nIterations, nEvents;
+        std::istringstream is(newValue);
+        is >> nIterations >> nEvents;
+        // the first pilot runs analogue, the next ones on the previous windows
+        fWindows->SetPilot(true);
+        fWindows->SetApply(false);
+        for (G4int i = 0; i < nIterations; i++) {
+            G4cout << " ---> Weight-window pilot " << i + 1 << "/" << nIterations << G4endl;
+            G4RunManager::GetRunManager()->BeamOn(nEvents);
+            fWindows->SetApply(true);
+        }
+        fWindows->SetPilot(false);
+    }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
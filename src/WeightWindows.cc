@@ -0,0 +1,249 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file WeightWindows.cc
+/// \brief Implementation of the WeightWindows class
+//
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "WeightWindows.hh"
+
+#include "DetectorConstruction.hh"
+#include "WeightWindowMessenger.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+
+#include <fstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::Tally::Configure(std::size_t nCells, G4bool active)
+{
+    fActive = active;
+    fWeight.assign(active ? nCells : 0, 0.);
+    fCredit.assign(active ? nCells : 0, 0.);
+    fTotalScore = 0.;
+    fEventWeight.assign(active ? nCells : 0, 0.);
+    fEntered.clear();
+    fEventScore = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::Tally::EndEvent()
+{
+    // every cell entered shares the score of the whole history, once per
+    // history however many tracks entered it
+    for (G4int cell : fEntered) {
+        fWeight[cell] += fEventWeight[cell];
+        if (fEventScore > 0.) fCredit[cell] += fEventScore;
+        fEventWeight[cell] = 0.;
+    }
+    fTotalScore += fEventScore;
+    fEntered.clear();
+    fEventScore = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::Tally::Merge(const Tally& other)
+{
+    if (!other.fActive) return;
+    if (fWeight.size() != other.fWeight.size()) {
+        fActive = true;
+        fWeight.assign(other.fWeight.size(), 0.);
+        fCredit.assign(other.fCredit.size(), 0.);
+    }
+    for (std::size_t i = 0; i < fWeight.size(); i++) {
+        fWeight[i] += other.fWeight[i];
+        fCredit[i] += other.fCredit[i];
+    }
+    fTotalScore += other.fTotalScore;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WeightWindows::WeightWindows(DetectorConstruction* det) : fDetector(det)
+{
+    fEmin = 1.*meV;
+    fEmax = 20.*MeV;
+    fMessenger = new WeightWindowMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+WeightWindows::~WeightWindows()
+{
+    delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::SetMesh(G4int nx, G4int ny, G4int nz)
+{
+    fN[0] = nx;
+    fN[1] = ny;
+    fN[2] = nz;
+    fLower.clear();
+    fLoaded = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::SetBox(const G4ThreeVector& lo, const G4ThreeVector& hi)
+{
+    fLo = lo;
+    fHi = hi;
+    fLower.clear();
+    fLoaded = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::SetEnergyGroups(G4int n, G4double emin, G4double emax)
+{
+    fNGroups = n;
+    fEmin = emin;
+    fEmax = emax;
+    fLower.clear();
+    fLoaded = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::Resolve()
+{
+    if (!fPilot && !fApply) return;
+
+    // a loaded map keeps its own mesh
+    if (!fLoaded) {
+        if (fLo == fHi) fDetector->GetWorld()->GetLogicalVolume()->GetSolid()->BoundingLimits(fLo, fHi);
+        std::size_t nCells = (std::size_t)fN[0] * fN[1] * fN[2] * fNGroups;
+        if (fLower.size() != nCells) fLower.assign(nCells, 0.);
+    }
+    G4ThreeVector width = fHi - fLo;
+    fInvWidth = G4ThreeVector(fN[0] / width.x(), fN[1] / width.y(), fN[2] / width.z());
+    fInvLogWidth = fNGroups > 1 ? fNGroups / std::log(fEmax / fEmin) : 0.;
+
+    G4int nSet = std::count_if(fLower.begin(), fLower.end(), [](G4double lower) { return lower > 0.; });
+    G4cout << " ---> Weight windows: " << fN[0] << " x " << fN[1] << " x " << fN[2] << " x " << fNGroups
+        << " cells over " << G4BestUnit(fLo, "Length") << " -> " << G4BestUnit(fHi, "Length")
+        << ", " << nSet << " with a window" << (fPilot ? " (pilot)" : "") 
+        << (fApply ? " (applied)" : "") << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::Update(const Tally& tally, G4int nPrimaries)
+{
+    if (tally.fTotalScore <= 0. || nPrimaries <= 0 || tally.fWeight.size() != fLower.size()) {
+        G4Exception("WeightWindows::Update()", "WeightWindow01", JustWarning,
+                "pilot run scored nothing in the panel, weight windows unchanged");
+        return;
+    }
+
+    // importance of a unit-weight primary is the score per primary; the
+    // survival weight of a cell is that over the cell's importance
+    G4double source = tally.fTotalScore / nPrimaries;
+    G4int nSet = 0;
+    for (std::size_t i = 0; i < fLower.size(); i++) {
+        // cells the pilot never reached keep their previous window
+        if (tally.fWeight[i] <= 0.) continue;
+        if (tally.fCredit[i] > 0.) {
+            G4double importance = tally.fCredit[i] / tally.fWeight[i];
+            fLower[i] = 2. * (source / importance) / (1. + fRatio);
+        }
+        else {
+            fLower[i] = 0.;
+        }
+        if (fLower[i] > 0.) nSet++;
+    }
+    G4cout << " ---> Weight windows updated from " << nPrimaries << " primaries, score "
+        << tally.fTotalScore << ": " << nSet << " cells with a window" << G4endl;
+
+    Save(fFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void WeightWindows::Save(const G4String& fileName) const
+{
+    std::ofstream out(fileName);
+    if (!out) {
+        G4Exception("WeightWindows::Save()", "WeightWindow02", JustWarning, ("cannot open " + fileName).c_str());
+        return;
+    }
+    out.precision(10);
+    out << "# LDRS weight windows: nx ny nz nGroups / lo hi (mm) / emin emax (MeV) / ratio / lower bounds\n";
+    out << fN[0] << " " << fN[1] << " " << fN[2] << " " << fNGroups << "\n";
+    out << fLo.x() / mm << " " << fLo.y() / mm << " " << fLo.z() / mm << " "
+        << fHi.x() / mm << " " << fHi.y() / mm << " " << fHi.z() / mm << "\n";
+    out << fEmin / MeV << " " << fEmax / MeV << "\n" << fRatio << "\n";
+    for (G4double lower : fLower) out << lower << "\n";
+    G4cout << " ---> Weight windows written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool WeightWindows::Load(const G4String& fileName)
+{
+    std::ifstream in(fileName);
+    std::string header;
+    if (!in || !std::getline(in, header)) {
+        G4Exception("WeightWindows::Load()", "WeightWindow03", JustWarning, ("cannot read " + fileName).c_str());
+        return false;
+    }
+    G4int n[3], nGroups;
+    G4double lo[3], hi[3], emin, emax, ratio;
+    in >> n[0] >> n[1] >> n[2] >> nGroups >> lo[0] >> lo[1] >> lo[2] >> hi[0] >> hi[1] >> hi[2]
+       >> emin >> emax >> ratio;
+    std::size_t nCells = (std::size_t)n[0] * n[1] * n[2] * nGroups;
+    std::vector<G4double> lower(nCells);
+    for (auto& value : lower) in >> value;
+    if (!in) {
+        G4Exception("WeightWindows::Load()", "WeightWindow04", JustWarning, (fileName + " is truncated").c_str());
+        return false;
+    }
+
+    for (G4int i = 0; i < 3; i++) fN[i] = n[i];
+    fNGroups = nGroups;
+    fLo = G4ThreeVector(lo[0], lo[1], lo[2]) * mm;
+    fHi = G4ThreeVector(hi[0], hi[1], hi[2]) * mm;
+    fEmin = emin * MeV;
+    fEmax = emax * MeV;
+    fRatio = ratio;
+    fLower.swap(lower);
+    fLoaded = true;
+    G4cout << " ---> Weight windows read from " << fileName << G4endl;
+    return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,219 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+/// \file ldrs_merge.cc
+/// \brief Offline merge of the per-thread output files of unmerged runs
+//
+//   ldrs_merge [-j threads] [-o output] [--per-job] files-or-directories...
+//
+// Groups the <stem>[_NNNNNN][_t<thread>].root files of /LDRS/run/setNtupleMerging
+// false runs: the thread suffix always goes, the job number (HistoManager's
+// file number) too unless --per-job. Each group is merged into
+// <stem>[_NNNNNN]_merged.root with TFileMerger: trees are concatenated by
+// copying their compressed baskets (fast cloning; the output takes the
+// compression of the first input so that baskets are never repacked) and
+// histograms are summed. With several threads the inputs are split into
+// contiguous chunks merged concurrently into partial files, which are then
+// merged in turn: a two-level reduction in which every basket is copied
+// twice at most.
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TROOT.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+static void Usage()
+{
+    std::cout << "usage: ldrs_merge [-j threads] [-o output] [--per-job] files-or-directories...\n"
+              << "  merges <stem>[_NNNNNN][_t<thread>].root into <stem>_merged.root\n"
+              << "  -j         merging threads (default: all cores)\n"
+              << "  -o         output file, when the inputs form a single group\n"
+              << "  --per-job  keep the job number: <stem>_NNNNNN_merged.root per job" << std::endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// one TFileMerger pass; fast cloning copies the baskets without unpacking them
+static bool MergeFiles(const std::vector<std::string>& inputs, const std::string& output, int compression)
+{
+    TFileMerger merger(kFALSE, kFALSE);
+    merger.SetPrintLevel(0);
+    merger.SetFastMethod(kTRUE);
+    if (!merger.OutputFile(output.c_str(), "RECREATE", compression)) return false;
+    for (const auto& input : inputs) {
+        if (!merger.AddFile(input.c_str(), kFALSE)) return false;
+    }
+    return merger.Merge();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+static bool MergeGroup(const std::vector<std::string>& inputs, const std::string& output, unsigned nThreads)
+{
+    int compression = 0;
+    {
+        std::unique_ptr<TFile> first(TFile::Open(inputs.front().c_str(), "READ"));
+        if (!first || first->IsZombie()) {
+            std::cerr << " ---> cannot open " << inputs.front() << std::endl;
+            return false;
+        }
+        compression = first->GetCompressionSettings();
+    }
+
+    // at least two files per chunk, or the partial pass buys nothing
+    std::size_t nChunks = std::min<std::size_t>(nThreads, inputs.size() / 2);
+    if (nChunks < 2) return MergeFiles(inputs, output, compression);
+
+    std::vector<std::string> parts(nChunks);
+    std::vector<char> merged(nChunks, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < nChunks; c++) {
+        parts[c] = output + ".part" + std::to_string(c);
+        threads.emplace_back([&, c]() {
+            // contiguous chunks keep the entries in file order
+            std::size_t begin = inputs.size() * c / nChunks;
+            std::size_t end = inputs.size() * (c + 1) / nChunks;
+            std::vector<std::string> chunk(inputs.begin() + begin, inputs.begin() + end);
+            merged[c] = MergeFiles(chunk, parts[c], compression);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    bool done = std::all_of(merged.begin(), merged.end(), [](char ok) { return ok != 0; })
+               && MergeFiles(parts, output, compression);
+    for (const auto& part : parts) std::remove(part.c_str());
+    return done;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+    unsigned nThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::string output;
+    bool perJob = false;
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) nThreads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (arg == "--per-job") perJob = true;
+        else if (arg == "-h" || arg == "--help") { Usage(); return 0; }
+        else inputs.push_back(arg);
+    }
+    if (inputs.empty()) {
+        Usage();
+        return 1;
+    }
+
+    // <stem>[_NNNNNN][_t<thread>].root, grouped per directory
+    const std::regex pattern(R"(^(.*?)(?:_(\d{6}))?(?:_t(\d+))?\.root$)");
+    const std::string suffix = "_merged.root";
+    // job and thread numbers, -1 when absent (the master's own file)
+    struct Input
+    {
+        long job;
+        long thread;
+        std::string path;
+        bool operator<(const Input& other) const
+        {
+            return std::tie(job, thread, path) < std::tie(other.job, other.thread, other.path);
+        }
+    };
+    std::map<std::string, std::vector<Input>> groups;
+    auto add = [&](const fs::path& path) {
+        std::string file = path.filename().string();
+        if (file.size() >= suffix.size() && file.compare(file.size() - suffix.size(), suffix.size(), suffix) == 0) return;
+        std::smatch match;
+        if (!std::regex_match(file, match, pattern)) return;
+        std::string key = match[1].str();
+        if (perJob && match[2].matched) key += "_" + match[2].str();
+        long job = match[2].matched ? std::stol(match[2].str()) : -1;
+        long thread = match[3].matched ? std::stol(match[3].str()) : -1;
+        groups[(path.parent_path() / key).string()].push_back({job, thread, path.string()});
+    };
+    for (const auto& input : inputs) {
+        if (fs::is_directory(input)) {
+            for (const auto& entry : fs::directory_iterator(input)) {
+                if (entry.is_regular_file()) add(entry.path());
+            }
+        }
+        else if (fs::exists(input)) {
+            add(input);
+        }
+        else {
+            std::cerr << " ---> no such file " << input << std::endl;
+        }
+    }
+    if (groups.empty()) {
+        std::cerr << " ---> nothing to merge" << std::endl;
+        return 1;
+    }
+    if (!output.empty() && groups.size() > 1) {
+        std::cerr << " ---> -o needs a single group, the inputs form " << groups.size() << std::endl;
+        return 1;
+    }
+
+    // one TFile per thread and no shared objects between the chunks
+    ROOT::EnableThreadSafety();
+
+    int failed = 0;
+    for (auto& [key, group] : groups) {
+        // job, then thread order, numerically (_t10 after _t2)
+        std::sort(group.begin(), group.end());
+        std::vector<std::string> files;
+        for (const auto& input : group) files.push_back(input.path);
+        std::string target = output.empty() ? key + suffix : output;
+        auto start = std::chrono::steady_clock::now();
+        bool done = MergeGroup(files, target, nThreads);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << " ---> " << target << ": " << files.size() << " files, "
+                  << elapsed.count() << " s" << (done ? "" : ", FAILED") << std::endl;
+        if (!done) failed++;
+    }
+    return failed == 0 ? 0 : 2;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......